@@ -0,0 +1,175 @@
+// Allocations per write() and read() call, as a regression metric.
+//
+// Built with SHM_TRACK_ALLOCATIONS and the global allocation hooks, so the
+// library counts the heap allocations each call makes on the calling thread.
+// For every payload size (or a sample document from a file) it writes and
+// reads the channel repeatedly and prints one JSON line with allocations and
+// allocated bytes per call for write(), read() and readSerialized().
+//
+// --max-write-allocs / --max-read-allocs turn it into a gate: the exit status
+// is 1 if any case exceeds the budget.
+
+#define SHM_TRACK_ALLOCATIONS
+#include "shared_memory_json.hpp"
+#include "bench_common.hpp"
+
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+SHM_DEFINE_ALLOCATION_HOOKS()
+
+namespace {
+
+struct Config {
+    std::vector<uint64_t> sizes = {64, 1024, 16 * 1024, 256 * 1024};
+    std::string document;             // Sample document file; replaces --sizes
+    uint64_t iterations = 1000;
+    double max_write_allocs = -1;     // Per write() call; negative = no budget
+    double max_read_allocs = -1;      // Per read() call; negative = no budget
+    std::string output;
+};
+
+// Array of small records, the shape of a typical status document
+json makePayload(uint64_t size) {
+    json items = json::array();
+    json payload = {{"sequence", 0}, {"items", items}};
+    uint64_t id = 0;
+    while (payload.dump().size() < size) {
+        payload["items"].push_back({{"id", id}, {"name", "item_" + std::to_string(id)}, {"value", id * 1.5}});
+        id++;
+    }
+    return payload;
+}
+
+json measureCase(const Config& config, const json& payload, bool& within_budget) {
+    uint64_t max_size = payload.dump().size() + 64;
+    SharedMemoryJSON channel("alloc_bench", max_size, true);
+    json data;
+    std::string text;
+    uint64_t sequence, timestamp;
+
+    channel.write(payload); // Warm up
+    channel.resetAllocationStats();
+    for (uint64_t i = 0; i < config.iterations; ++i) {
+        channel.write(payload);
+    }
+    AllocationStats write_stats = channel.getAllocationStats();
+
+    channel.resetAllocationStats();
+    for (uint64_t i = 0; i < config.iterations; ++i) {
+        channel.read(data);
+    }
+    AllocationStats read_stats = channel.getAllocationStats();
+
+    channel.resetAllocationStats();
+    for (uint64_t i = 0; i < config.iterations; ++i) {
+        channel.readSerialized(text, sequence, timestamp);
+    }
+    AllocationStats serialized_stats = channel.getAllocationStats();
+
+    if ((config.max_write_allocs >= 0 && write_stats.allocationsPerWrite() > config.max_write_allocs) ||
+        (config.max_read_allocs >= 0 && read_stats.allocationsPerRead() > config.max_read_allocs)) {
+        within_budget = false;
+    }
+
+    return {
+        {"payload_bytes", payload.dump().size()},
+        {"iterations", config.iterations},
+        {"write", {{"allocs_per_call", write_stats.allocationsPerWrite()},
+                   {"bytes_per_call", write_stats.bytesPerWrite()}}},
+        {"read", {{"allocs_per_call", read_stats.allocationsPerRead()},
+                  {"bytes_per_call", read_stats.bytesPerRead()}}},
+        {"read_serialized", {{"allocs_per_call", serialized_stats.allocationsPerRead()},
+                             {"bytes_per_call", serialized_stats.bytesPerRead()}}}
+    };
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --sizes LIST            Payload sizes, e.g. 64,1K,256K (default 64,1K,16K,256K)\n"
+              << "  --document FILE         Measure this JSON document instead of generated payloads\n"
+              << "  --iterations N          Calls per operation (default 1000)\n"
+              << "  --max-write-allocs N    Fail if write() makes more allocations per call\n"
+              << "  --max-read-allocs N     Fail if read() makes more allocations per call\n"
+              << "  --output FILE           Append JSON lines to FILE instead of stdout" << std::endl;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--sizes") {
+            config.sizes = bench::parseSizeList(value);
+        } else if (arg == "--document") {
+            config.document = value;
+        } else if (arg == "--iterations") {
+            config.iterations = std::stoull(value);
+        } else if (arg == "--max-write-allocs") {
+            config.max_write_allocs = std::stod(value);
+        } else if (arg == "--max-read-allocs") {
+            config.max_read_allocs = std::stod(value);
+        } else if (arg == "--output") {
+            config.output = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (config.iterations == 0) {
+        throw std::invalid_argument("--iterations must be positive");
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Config config = parseArgs(argc, argv);
+
+        std::ofstream file;
+        if (!config.output.empty()) {
+            file.open(config.output, std::ios::app);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + config.output);
+            }
+        }
+        std::ostream& out = config.output.empty() ? std::cout : file;
+
+        std::vector<json> payloads;
+        if (!config.document.empty()) {
+            std::ifstream document(config.document);
+            if (!document) {
+                throw std::runtime_error("Cannot open " + config.document);
+            }
+            payloads.push_back(json::parse(document));
+        } else {
+            for (uint64_t size : config.sizes) {
+                payloads.push_back(makePayload(size));
+            }
+        }
+
+        bool within_budget = true;
+        for (const json& payload : payloads) {
+            out << measureCase(config, payload, within_budget).dump() << std::endl;
+        }
+        if (!within_budget) {
+            std::cerr << "alloc_bench: allocation budget exceeded" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
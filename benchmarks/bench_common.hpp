@@ -0,0 +1,145 @@
+#pragma once
+
+// Helpers shared by the benchmark programs (POSIX only: they fork worker processes)
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace bench {
+
+/**
+ * CLOCK_MONOTONIC in nanoseconds; comparable across processes on the same host
+ */
+inline uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * Anonymous MAP_SHARED region holding a T, visible to processes forked after construction
+ */
+template <typename T>
+class SharedRegion {
+public:
+    SharedRegion() {
+        void* ptr = mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error("Failed to map shared region: " + std::string(strerror(errno)));
+        }
+        value_ = new (ptr) T();
+    }
+
+    ~SharedRegion() {
+        value_->~T();
+        munmap(value_, sizeof(T));
+    }
+
+    // Prevent copying
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    T* operator->() { return value_; }
+    T& operator*() { return *value_; }
+
+private:
+    T* value_;
+};
+
+/**
+ * Fork a child that runs body() and exits with its return value without
+ * running the parent's destructors
+ */
+template <typename Body>
+pid_t spawn(Body body) {
+    pid_t pid = fork();
+    if (pid == -1) {
+        throw std::runtime_error("fork failed: " + std::string(strerror(errno)));
+    }
+    if (pid == 0) {
+        int status = 1;
+        try {
+            status = body();
+        } catch (...) {
+        }
+        _exit(status);
+    }
+    return pid;
+}
+
+/**
+ * Wait for all children; returns false if any exited abnormally
+ */
+inline bool waitAll(const std::vector<pid_t>& children) {
+    bool ok = true;
+    for (pid_t child : children) {
+        int status = 0;
+        if (waitpid(child, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * Parse a size with an optional K/M/G suffix (powers of 1024), e.g. "64", "4K", "10M"
+ */
+inline uint64_t parseSize(const std::string& text) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) {
+        throw std::invalid_argument("Invalid size: " + text);
+    }
+    switch (*end) {
+        case 'k': case 'K': value *= 1024.0; ++end; break;
+        case 'm': case 'M': value *= 1024.0 * 1024.0; ++end; break;
+        case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; ++end; break;
+        default: break;
+    }
+    if (*end == 'B' || *end == 'b') {
+        ++end;
+    }
+    if (*end != '\0') {
+        throw std::invalid_argument("Invalid size: " + text);
+    }
+    return static_cast<uint64_t>(value);
+}
+
+/**
+ * Split a comma-separated option value
+ */
+inline std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+inline std::vector<uint64_t> parseSizeList(const std::string& text) {
+    std::vector<uint64_t> sizes;
+    for (const std::string& item : splitList(text)) {
+        sizes.push_back(parseSize(item));
+    }
+    return sizes;
+}
+
+} // namespace bench
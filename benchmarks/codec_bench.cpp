@@ -0,0 +1,451 @@
+// Codec and read-mode comparison for one JSON document.
+//
+// Takes a sample document (ideally one of ours, from a file) and measures,
+// for text JSON, CBOR, MessagePack, BSON and UBJSON:
+//
+//   - encoded size
+//   - encode and decode time per call
+//   - heap allocations and allocated bytes per call
+//
+// With --pointer, two partial read modes are measured as well: a full decode
+// followed by a JSON pointer lookup, and a lazy SAX scan that stops as soon
+// as the pointed-to value has been read. The recommendation weighs one encode
+// (the writer) against --readers decodes.
+
+#define SHM_TRACK_ALLOCATIONS
+#include "shared_memory_json.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+using json = nlohmann::json;
+
+// Count every heap allocation made by this process
+SHM_DEFINE_ALLOCATION_HOOKS()
+
+namespace {
+
+struct Config {
+    std::string document;          // File with the sample document; built-in sample if empty
+    std::string pointer;           // JSON pointer for partial reads, e.g. /services/3/status
+    uint64_t readers = 1;          // Decodes per encode when ranking
+    uint64_t time_ms = 200;        // Measuring time per operation
+    bool as_json = false;
+};
+
+struct Codec {
+    std::string name;
+    json::input_format_t format;
+    std::function<std::string(const json&)> encode;
+    std::function<json(const std::string&)> decode;
+};
+
+struct Measurement {
+    double ns = 0;                 // Per call
+    double allocations = 0;        // Per call
+    double allocated_bytes = 0;    // Per call
+};
+
+struct Result {
+    std::string codec;
+    std::string read;              // full | pointer | lazy
+    size_t encoded_bytes = 0;
+    Measurement encode;
+    Measurement decode;
+    double cost_ns = 0;            // encode + readers * decode
+};
+
+/**
+ * SAX handler that extracts the value at one JSON pointer and stops parsing
+ * as soon as it is complete. Everything before it is tokenized but never
+ * materialized; everything after it is not even scanned.
+ */
+class PointerSax {
+public:
+    explicit PointerSax(const std::string& pointer) {
+        // Split "/a/b~1c" into {"a", "b/c"}
+        size_t start = 1;
+        while (start <= pointer.size() && !pointer.empty()) {
+            size_t end = pointer.find('/', start);
+            std::string token = pointer.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            for (size_t pos = 0; (pos = token.find('~', pos)) != std::string::npos; ++pos) {
+                token.replace(pos, 2, token.compare(pos, 2, "~1") == 0 ? "/" : "~");
+            }
+            target_.push_back(token);
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    bool found() const { return found_; }
+    const json& value() const { return value_; }
+
+    bool null() { return scalar(nullptr); }
+    bool boolean(bool value) { return scalar(value); }
+    bool number_integer(json::number_integer_t value) { return scalar(value); }
+    bool number_unsigned(json::number_unsigned_t value) { return scalar(value); }
+    bool number_float(json::number_float_t value, const json::string_t&) { return scalar(value); }
+    bool string(json::string_t& value) { return scalar(std::move(value)); }
+    bool binary(json::binary_t& value) { return scalar(json::binary(std::move(value))); }
+    bool start_object(std::size_t) { return startContainer(false); }
+    bool start_array(std::size_t) { return startContainer(true); }
+    bool end_object() { return endContainer(); }
+    bool end_array() { return endContainer(); }
+
+    bool key(json::string_t& key) {
+        if (capturing_) {
+            pending_key_ = key;
+        } else {
+            frames_.back().key = key;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) { return false; }
+
+private:
+    struct Frame {
+        bool array;
+        size_t index;
+        std::string key;
+    };
+
+    bool atTarget() const {
+        if (frames_.size() != target_.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < frames_.size(); ++i) {
+            const Frame& frame = frames_[i];
+            if (frame.array ? target_[i] != std::to_string(frame.index) : target_[i] != frame.key) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void advance() {
+        if (!frames_.empty() && frames_.back().array) {
+            frames_.back().index++;
+        }
+    }
+
+    json* insert(json value) {
+        json& parent = *building_.back();
+        if (parent.is_array()) {
+            parent.push_back(std::move(value));
+            return &parent.back();
+        }
+        json& slot = parent[pending_key_];
+        slot = std::move(value);
+        return &slot;
+    }
+
+    bool scalar(json value) {
+        if (capturing_) {
+            insert(std::move(value));
+            return true;
+        }
+        if (atTarget()) {
+            value_ = std::move(value);
+            found_ = true;
+            return false; // Done - stop parsing
+        }
+        advance();
+        return true;
+    }
+
+    bool startContainer(bool array) {
+        json empty = array ? json::array() : json::object();
+        if (capturing_) {
+            building_.push_back(insert(std::move(empty)));
+        } else if (atTarget()) {
+            capturing_ = true;
+            value_ = std::move(empty);
+            building_.push_back(&value_);
+        } else {
+            frames_.push_back({array, 0, {}});
+        }
+        return true;
+    }
+
+    bool endContainer() {
+        if (capturing_) {
+            building_.pop_back();
+            if (building_.empty()) {
+                found_ = true;
+                return false;
+            }
+            return true;
+        }
+        frames_.pop_back();
+        advance();
+        return true;
+    }
+
+    std::vector<std::string> target_;
+    std::vector<Frame> frames_;
+    std::vector<json*> building_;
+    std::string pending_key_;
+    bool capturing_ = false;
+    bool found_ = false;
+    json value_;
+};
+
+volatile size_t g_sink = 0; // Keeps measured results observable
+
+/**
+ * Run op repeatedly for about time_ms and return per-call time and allocations
+ */
+template <typename Op>
+Measurement measure(uint64_t time_ms, Op op) {
+    g_sink = g_sink + op(); // Warm up caches and allocator
+
+    uint64_t start = bench::nowNs();
+    g_sink = g_sink + op();
+    uint64_t single = std::max<uint64_t>(bench::nowNs() - start, 1);
+    uint64_t iterations = std::max<uint64_t>(10, time_ms * 1000000 / single);
+
+    const shared_memory::detail::AllocationCounter& counter = shared_memory::detail::thread_allocations;
+    uint64_t allocations = counter.count;
+    uint64_t bytes = counter.bytes;
+    start = bench::nowNs();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        g_sink = g_sink + op();
+    }
+    uint64_t elapsed = bench::nowNs() - start;
+
+    Measurement result;
+    result.ns = static_cast<double>(elapsed) / static_cast<double>(iterations);
+    result.allocations = static_cast<double>(counter.count - allocations) / static_cast<double>(iterations);
+    result.allocated_bytes = static_cast<double>(counter.bytes - bytes) / static_cast<double>(iterations);
+    return result;
+}
+
+std::vector<Codec> codecs() {
+    using fmt = json::input_format_t;
+    return {
+        {"json", fmt::json,
+         [](const json& j) { return j.dump(); },
+         [](const std::string& s) { return json::parse(s); }},
+        {"cbor", fmt::cbor,
+         [](const json& j) { std::string s; json::to_cbor(j, s); return s; },
+         [](const std::string& s) { return json::from_cbor(s); }},
+        {"msgpack", fmt::msgpack,
+         [](const json& j) { std::string s; json::to_msgpack(j, s); return s; },
+         [](const std::string& s) { return json::from_msgpack(s); }},
+        {"bson", fmt::bson,
+         [](const json& j) { std::string s; json::to_bson(j, s); return s; },
+         [](const std::string& s) { return json::from_bson(s); }},
+        {"ubjson", fmt::ubjson,
+         [](const json& j) { std::string s; json::to_ubjson(j, s); return s; },
+         [](const std::string& s) { return json::from_ubjson(s); }},
+    };
+}
+
+// Stand-in shaped like a busy status channel when no document is given
+json sampleDocument() {
+    json services = json::array();
+    for (int i = 0; i < 50; ++i) {
+        services.push_back({
+            {"name", "service_" + std::to_string(i)},
+            {"status", i % 7 == 0 ? "degraded" : "running"},
+            {"uptime_s", 86400 + i * 37},
+            {"load", {0.25 + i * 0.01, 0.5, 0.75}},
+            {"requests", {{"total", 1000000 + i}, {"failed", i * 3}, {"p99_ms", 12.5 + i}}},
+            {"tags", {"prod", "eu-west", "tier-" + std::to_string(i % 3)}}
+        });
+    }
+    return {{"host", "node-17"}, {"timestamp", 1700000000123ull}, {"services", services}};
+}
+
+std::vector<Result> run(const Config& config, const json& document) {
+    std::vector<Result> results;
+    json::json_pointer pointer(config.pointer);
+
+    for (const Codec& codec : codecs()) {
+        std::string encoded;
+        try {
+            encoded = codec.encode(document);
+        } catch (const json::exception& e) {
+            std::cerr << "codec_bench: " << codec.name << " cannot encode this document: " << e.what() << std::endl;
+            continue;
+        }
+
+        Result full;
+        full.codec = codec.name;
+        full.read = "full";
+        full.encoded_bytes = encoded.size();
+        full.encode = measure(config.time_ms, [&]() { return codec.encode(document).size(); });
+        full.decode = measure(config.time_ms, [&]() { return codec.decode(encoded).size(); });
+        results.push_back(full);
+
+        if (config.pointer.empty()) {
+            continue;
+        }
+
+        Result by_pointer = full;
+        by_pointer.read = "pointer";
+        by_pointer.decode = measure(config.time_ms, [&]() { return codec.decode(encoded).at(pointer).size(); });
+        results.push_back(by_pointer);
+
+        Result lazy = full;
+        lazy.read = "lazy";
+        lazy.decode = measure(config.time_ms, [&]() {
+            PointerSax sax(config.pointer);
+            json::sax_parse(encoded, &sax, codec.format);
+            if (!sax.found()) {
+                throw std::runtime_error("Pointer " + config.pointer + " not found by lazy " + codec.name + " read");
+            }
+            return sax.value().size();
+        });
+        results.push_back(lazy);
+    }
+
+    for (Result& result : results) {
+        result.cost_ns = result.encode.ns + static_cast<double>(config.readers) * result.decode.ns;
+    }
+    return results;
+}
+
+json toJson(const Result& result, const Config& config) {
+    return {
+        {"codec", result.codec},
+        {"read", result.read},
+        {"pointer", config.pointer},
+        {"encoded_bytes", result.encoded_bytes},
+        {"encode_ns", result.encode.ns},
+        {"encode_allocs", result.encode.allocations},
+        {"encode_alloc_bytes", result.encode.allocated_bytes},
+        {"decode_ns", result.decode.ns},
+        {"decode_allocs", result.decode.allocations},
+        {"decode_alloc_bytes", result.decode.allocated_bytes},
+        {"readers", config.readers},
+        {"cost_ns", result.cost_ns}
+    };
+}
+
+void printTable(const std::vector<Result>& results) {
+    std::cout << std::left << std::setw(9) << "CODEC" << std::setw(9) << "READ" << std::right
+              << std::setw(10) << "BYTES" << std::setw(12) << "ENCODE_ns" << std::setw(10) << "ENC_ALLOC"
+              << std::setw(12) << "DECODE_ns" << std::setw(10) << "DEC_ALLOC" << std::setw(12) << "DEC_BYTES"
+              << std::setw(12) << "COST_ns" << std::endl;
+    std::cout << std::fixed;
+    for (const Result& r : results) {
+        std::cout << std::left << std::setw(9) << r.codec << std::setw(9) << r.read << std::right
+                  << std::setw(10) << r.encoded_bytes
+                  << std::setprecision(0) << std::setw(12) << r.encode.ns
+                  << std::setprecision(1) << std::setw(10) << r.encode.allocations
+                  << std::setprecision(0) << std::setw(12) << r.decode.ns
+                  << std::setprecision(1) << std::setw(10) << r.decode.allocations
+                  << std::setprecision(0) << std::setw(12) << r.decode.allocated_bytes
+                  << std::setw(12) << r.cost_ns << std::endl;
+    }
+}
+
+void printRecommendation(const std::vector<Result>& results, const Config& config) {
+    auto fastest = std::min_element(results.begin(), results.end(),
+                                    [](const Result& a, const Result& b) { return a.cost_ns < b.cost_ns; });
+    auto smallest = std::min_element(results.begin(), results.end(),
+                                     [](const Result& a, const Result& b) { return a.encoded_bytes < b.encoded_bytes; });
+    auto text = std::find_if(results.begin(), results.end(),
+                             [](const Result& r) { return r.codec == "json" && r.read == "full"; });
+
+    std::cout << "\nRecommendation for " << config.readers << " reader(s) per write: "
+              << fastest->codec << " with " << fastest->read << " reads";
+    if (text != results.end() && fastest != text) {
+        std::cout << " (" << std::setprecision(1) << text->cost_ns / fastest->cost_ns << "x faster than text JSON)";
+    }
+    std::cout << std::endl;
+    std::cout << "Smallest encoding: " << smallest->codec << " (" << smallest->encoded_bytes << " bytes)" << std::endl;
+    if (fastest->codec != "json") {
+        std::cout << "Note: channels carry text JSON today; a binary codec would have to be added to use this." << std::endl;
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [document.json]\n"
+              << "  --pointer PTR   Also measure partial reads of the value at this JSON pointer\n"
+              << "  --readers N     Decodes per encode when ranking (default 1)\n"
+              << "  --time MS       Measuring time per operation (default 200)\n"
+              << "  --json          Print one JSON object per result instead of a table\n"
+              << "\nWithout a document a built-in sample shaped like a status channel is used." << std::endl;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--json") {
+            config.as_json = true;
+        } else if (arg == "--pointer" || arg == "--readers" || arg == "--time") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--pointer") {
+                config.pointer = value;
+            } else if (arg == "--readers") {
+                config.readers = std::stoull(value);
+            } else {
+                config.time_ms = std::stoull(value);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            config.document = arg;
+        }
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Config config = parseArgs(argc, argv);
+
+        json document;
+        if (config.document.empty()) {
+            document = sampleDocument();
+            if (config.pointer.empty()) {
+                config.pointer = "/services/42/requests";
+            }
+        } else {
+            std::ifstream file(config.document);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + config.document);
+            }
+            document = json::parse(file);
+        }
+        if (!config.pointer.empty() && !document.contains(json::json_pointer(config.pointer))) {
+            throw std::invalid_argument("Pointer " + config.pointer + " not found in the document");
+        }
+
+        std::vector<Result> results = run(config, document);
+        if (results.empty()) {
+            throw std::runtime_error("No codec could encode the document");
+        }
+
+        if (config.as_json) {
+            for (const Result& result : results) {
+                std::cout << toJson(result, config).dump() << std::endl;
+            }
+        } else {
+            printTable(results);
+            printRecommendation(results, config);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace bench {
+
+/**
+ * Fixed-size log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 2^SUB_BUCKET_BITS are recorded exactly; larger values keep
+ * SUB_BUCKET_BITS - 1 significant bits, so every reported percentile is within
+ * 1/64 (~1.6%) of the true value across the full 64-bit range.
+ *
+ * The histogram is trivially copyable and allocation-free, so benchmark child
+ * processes can record straight into a MAP_SHARED region and the parent can
+ * merge the results after waitpid().
+ */
+class HdrHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_COUNT = SUB_BUCKET_COUNT / 2;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * HALF_COUNT;
+
+    void record(uint64_t value) {
+        counts_[indexOf(value)]++;
+        total_++;
+        sum_ += value;
+        min_ = total_ == 1 ? value : std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const HdrHistogram& other) {
+        if (other.total_ == 0) {
+            return;
+        }
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        min_ = total_ == 0 ? other.min_ : std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        total_ += other.total_;
+        sum_ += other.sum_;
+    }
+
+    void reset() {
+        *this = HdrHistogram();
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return min_; }
+    uint64_t max() const { return max_; }
+
+    double mean() const {
+        return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0;
+    }
+
+    /**
+     * Value at the given percentile (0-100), reported as the upper bound of its bucket
+     */
+    uint64_t percentile(double p) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total_) + 0.5);
+        rank = std::min(std::max<uint64_t>(rank, 1), total_);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(upperBoundOf(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    /**
+     * Summary used in benchmark output
+     */
+    nlohmann::json summary() const {
+        return {
+            {"count", total_},
+            {"min", min_},
+            {"mean", mean()},
+            {"p50", percentile(50)},
+            {"p90", percentile(90)},
+            {"p99", percentile(99)},
+            {"p99_9", percentile(99.9)},
+            {"max", max_}
+        };
+    }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts_{};
+    uint64_t total_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = 0;
+    uint64_t max_ = 0;
+
+    static size_t indexOf(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        unsigned shift = msb - SUB_BUCKET_BITS + 1;
+        uint64_t top = value >> shift; // In [HALF_COUNT, SUB_BUCKET_COUNT)
+        return static_cast<size_t>(SUB_BUCKET_COUNT + (shift - 1) * HALF_COUNT + (top - HALF_COUNT));
+    }
+
+    static uint64_t upperBoundOf(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        uint64_t offset = index - SUB_BUCKET_COUNT;
+        unsigned shift = static_cast<unsigned>(offset / HALF_COUNT) + 1;
+        uint64_t top = HALF_COUNT + offset % HALF_COUNT;
+        return ((top + 1) << shift) - 1;
+    }
+};
+
+} // namespace bench
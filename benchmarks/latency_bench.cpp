@@ -0,0 +1,427 @@
+// Cross-process end-to-end latency benchmark for SharedMemoryJSON.
+//
+// Measures the time from write() in one process until the data has been
+// read and decoded in another, including the wakeup of the waiting reader.
+//
+//   one-way    A writer process stamps each message with CLOCK_MONOTONIC and
+//              publishes at a fixed rate; the reader records now - stamp.
+//   ping-pong  A client writes a ping, an echo process answers on a second
+//              channel, and the client records the round-trip time. This
+//              needs no clock shared between the two sides.
+//
+// Results go to stdout as one JSON line; the histogram is HDR-style with
+// ~1.6% precision (see hdr_histogram.hpp).
+
+#include "shared_memory_json.hpp"
+#include "shared_memory_busy_poll.hpp"
+#include "bench_common.hpp"
+#include "hdr_histogram.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+
+#if defined(__linux__)
+#include <poll.h>
+#endif
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+struct Config {
+    std::string mode = "one-way";   // one-way | ping-pong
+    std::string wait = "futex";     // futex | busy | notify
+    std::string read = "locked";    // locked | seqlock
+    uint64_t payload_bytes = 64;
+    uint64_t messages = 100000;
+    uint64_t warmup = 1000;
+    uint64_t rate_hz = 20000;       // one-way publish rate
+    int writer_cpu = -1;
+    int reader_cpu = -1;
+};
+
+struct Shared {
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> abort{false};
+    std::atomic<bool> writer_done{false};
+    std::atomic<bool> writer_pinned{false};
+    std::atomic<bool> reader_pinned{false};
+    uint64_t sent;
+    uint64_t received;
+    uint64_t timeouts;
+    bench::HdrHistogram latency;
+};
+
+/**
+ * One side's view of a channel: waits with the configured mechanism, then reads
+ */
+class Endpoint {
+public:
+    Endpoint(const std::string& name, size_t max_size, const Config& config, int cpu)
+        : channel_(name, max_size, false)
+        , wait_(config.wait)
+        , seqlock_(config.read == "seqlock")
+    {
+        if (wait_ == "busy") {
+            BusyPollOptions options;
+            options.cpu = cpu;
+            busy_.reset(new BusyPollReader(channel_, options));
+        } else if (wait_ == "notify" && channel_.getNotifyFd() == -1) {
+            throw std::runtime_error("Notify fd unavailable: " + channel_.getLastError());
+        }
+    }
+
+    /**
+     * Wait up to timeout_ms for a sequence newer than last_seq
+     */
+    bool wait(uint64_t last_seq, uint64_t timeout_ms) {
+        if (wait_ == "busy") {
+            return busy_->waitForUpdate(last_seq, timeout_ms * 1000);
+        }
+        if (wait_ == "notify") {
+#if defined(__linux__)
+            auto deadline = bench::nowNs() + timeout_ms * 1000000ull;
+            while (true) {
+                if (channel_.peekSequenceNumber() > last_seq) {
+                    return true;
+                }
+                uint64_t now = bench::nowNs();
+                if (now >= deadline) {
+                    return false;
+                }
+                pollfd pfd = {channel_.getNotifyFd(), POLLIN, 0};
+                poll(&pfd, 1, static_cast<int>((deadline - now) / 1000000 + 1));
+                channel_.consumeNotifications();
+            }
+#endif
+        }
+        return channel_.waitForUpdate(last_seq, timeout_ms);
+    }
+
+    bool read(json& data, uint64_t& sequence) {
+        if (!seqlock_) {
+            return channel_.read(data, sequence);
+        }
+        uint64_t timestamp;
+        if (!channel_.readSerialized(payload_, sequence, timestamp)) {
+            return false;
+        }
+        data = json::parse(payload_);
+        return true;
+    }
+
+    bool write(const json& data) {
+        return channel_.write(data);
+    }
+
+private:
+    SharedMemoryJSON channel_;
+    std::string wait_;
+    bool seqlock_;
+    std::unique_ptr<BusyPollReader> busy_;
+    std::string payload_;
+};
+
+json makeMessage(uint64_t payload_bytes) {
+    json doc = {{"i", 0}, {"t", 0}, {"blob", ""}};
+    size_t overhead = doc.dump().size() + 30; // Room for the index and stamp digits
+    doc["blob"] = std::string(payload_bytes > overhead ? payload_bytes - overhead : 0, 'x');
+    return doc;
+}
+
+bool pinIfRequested(int cpu) {
+    return cpu >= 0 && pinThreadToCpu(cpu);
+}
+
+void spinUntil(uint64_t deadline_ns) {
+    while (bench::nowNs() < deadline_ns) {
+    }
+}
+
+void waitForPeers(Shared& shared, uint32_t peers) {
+    while (shared.ready.load() < peers && !shared.abort.load()) {
+        std::this_thread::yield();
+    }
+}
+
+// ---- one-way -------------------------------------------------------------
+
+int oneWayWriter(const std::string& name, size_t max_size, const Config& config, Shared& shared) {
+    shared.writer_pinned = pinIfRequested(config.writer_cpu);
+    SharedMemoryJSON channel(name, max_size, false);
+    json doc = makeMessage(config.payload_bytes);
+    uint64_t interval_ns = config.rate_hz ? 1000000000ull / config.rate_hz : 0;
+
+    shared.ready.fetch_add(1);
+    waitForPeers(shared, 2);
+
+    uint64_t total = config.warmup + config.messages;
+    uint64_t next = bench::nowNs();
+    for (uint64_t i = 0; i < total && !shared.abort.load(); ++i) {
+        spinUntil(next);
+        doc["i"] = i;
+        doc["t"] = bench::nowNs();
+        if (channel.write(doc)) {
+            shared.sent++;
+        }
+        next += interval_ns;
+    }
+    shared.writer_done = true;
+    return 0;
+}
+
+int oneWayReader(const std::string& name, size_t max_size, const Config& config, Shared& shared) {
+    shared.reader_pinned = pinIfRequested(config.reader_cpu);
+    Endpoint endpoint(name, max_size, config, config.reader_cpu);
+    json data;
+    uint64_t last_seq;
+    endpoint.read(data, last_seq); // Skip the priming message
+
+    shared.ready.fetch_add(1);
+    waitForPeers(shared, 2);
+
+    uint64_t last_index = config.warmup + config.messages - 1;
+    while (!shared.abort.load()) {
+        if (!endpoint.wait(last_seq, 100)) {
+            if (shared.writer_done.load()) {
+                break; // Final message was coalesced away
+            }
+            shared.timeouts++;
+            continue;
+        }
+        uint64_t sequence;
+        if (!endpoint.read(data, sequence)) {
+            continue;
+        }
+        uint64_t now = bench::nowNs();
+        last_seq = sequence;
+
+        uint64_t index = data["i"].get<uint64_t>();
+        if (index >= config.warmup) {
+            shared.latency.record(now - data["t"].get<uint64_t>());
+            shared.received++;
+        }
+        if (index == last_index) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ---- ping-pong -----------------------------------------------------------
+
+int pingClient(const std::string& ping, const std::string& pong, size_t max_size, const Config& config, Shared& shared) {
+    shared.writer_pinned = pinIfRequested(config.writer_cpu);
+    SharedMemoryJSON out(ping, max_size, false);
+    Endpoint in(pong, max_size, config, config.writer_cpu);
+    json doc = makeMessage(config.payload_bytes);
+    json reply;
+    uint64_t last_seq = 0;
+    in.read(reply, last_seq);
+
+    shared.ready.fetch_add(1);
+    waitForPeers(shared, 2);
+
+    uint64_t total = config.warmup + config.messages;
+    for (uint64_t i = 0; i < total && !shared.abort.load(); ++i) {
+        uint64_t start = bench::nowNs();
+        doc["i"] = i;
+        doc["t"] = start;
+        if (!out.write(doc)) {
+            continue;
+        }
+        shared.sent++;
+
+        // Wait for the echo of this ping; a timeout means the echo was lost
+        bool answered = false;
+        while (!answered) {
+            if (!in.wait(last_seq, 1000)) {
+                shared.timeouts++;
+                break;
+            }
+            uint64_t sequence;
+            if (!in.read(reply, sequence)) {
+                continue;
+            }
+            last_seq = sequence;
+            answered = reply["i"].get<uint64_t>() == i;
+        }
+        if (answered && i >= config.warmup) {
+            shared.latency.record(bench::nowNs() - start);
+            shared.received++;
+        }
+    }
+    shared.writer_done = true;
+    return 0;
+}
+
+int pongEcho(const std::string& ping, const std::string& pong, size_t max_size, const Config& config, Shared& shared) {
+    shared.reader_pinned = pinIfRequested(config.reader_cpu);
+    Endpoint in(ping, max_size, config, config.reader_cpu);
+    SharedMemoryJSON out(pong, max_size, false);
+    json data;
+    uint64_t last_seq = 0;
+    in.read(data, last_seq);
+
+    shared.ready.fetch_add(1);
+    waitForPeers(shared, 2);
+
+    while (!shared.abort.load() && !shared.writer_done.load()) {
+        if (!in.wait(last_seq, 100)) {
+            continue;
+        }
+        uint64_t sequence;
+        if (in.read(data, sequence)) {
+            last_seq = sequence;
+            out.write(data);
+        }
+    }
+    return 0;
+}
+
+// ---- driver --------------------------------------------------------------
+
+json run(const Config& config) {
+    std::string base = "latency_bench_" + std::to_string(getpid());
+    std::string ping = base + "_ping";
+    std::string pong = base + "_pong";
+    json prime = makeMessage(config.payload_bytes);
+    prime["i"] = UINT64_MAX;
+    size_t max_size = prime.dump().size() + 4096;
+
+    // The parent owns the channels so they outlive both children
+    SharedMemoryJSON ping_channel(ping, max_size, true);
+    SharedMemoryJSON pong_channel(pong, max_size, true);
+    ping_channel.write(prime);
+    pong_channel.write(prime);
+
+    bench::SharedRegion<Shared> shared;
+    std::vector<pid_t> children;
+    if (config.mode == "ping-pong") {
+        children.push_back(bench::spawn([&]() { return pongEcho(ping, pong, max_size, config, *shared); }));
+        children.push_back(bench::spawn([&]() { return pingClient(ping, pong, max_size, config, *shared); }));
+    } else {
+        children.push_back(bench::spawn([&]() { return oneWayReader(ping, max_size, config, *shared); }));
+        children.push_back(bench::spawn([&]() { return oneWayWriter(ping, max_size, config, *shared); }));
+    }
+
+    auto ready_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (shared->ready.load() < 2) {
+        if (std::chrono::steady_clock::now() > ready_deadline) {
+            shared->abort = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool ok = bench::waitAll(children) && !shared->abort.load();
+
+    json result = {
+        {"bench", "latency_bench"},
+        {"mode", config.mode},
+        {"metric", config.mode == "ping-pong" ? "round_trip" : "one_way"},
+        {"wait", config.wait},
+        {"read", config.read},
+        {"payload_bytes", prime.dump().size()},
+        {"messages", config.messages},
+        {"warmup", config.warmup},
+        {"sent", shared->sent},
+        {"received", shared->received},
+        {"timeouts", shared->timeouts},
+        {"writer_cpu", config.writer_cpu},
+        {"reader_cpu", config.reader_cpu},
+        {"writer_pinned", shared->writer_pinned.load()},
+        {"reader_pinned", shared->reader_pinned.load()},
+        {"latency_ns", shared->latency.summary()},
+        {"ok", ok}
+    };
+    if (config.mode == "one-way") {
+        result["rate_hz"] = config.rate_hz;
+    }
+    return result;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --mode one-way|ping-pong     What to measure (default one-way)\n"
+              << "  --wait futex|busy|notify     How the receiving side waits (default futex)\n"
+              << "  --read locked|seqlock        read() or readSerialized() + parse (default locked)\n"
+              << "  --size BYTES                 Payload size, K/M suffixes allowed (default 64)\n"
+              << "  --messages N                 Measured messages (default 100000)\n"
+              << "  --warmup N                   Messages sent before measuring (default 1000)\n"
+              << "  --rate HZ                    One-way publish rate, 0 = back-to-back (default 20000)\n"
+              << "  --writer-cpu N               Pin the writer / ping client to CPU N\n"
+              << "  --reader-cpu N               Pin the reader / echo process to CPU N\n"
+              << "\nExample: " << program << " --mode ping-pong --wait busy --writer-cpu 2 --reader-cpu 3" << std::endl;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--mode") {
+            config.mode = value;
+        } else if (arg == "--wait") {
+            config.wait = value;
+        } else if (arg == "--read") {
+            config.read = value;
+        } else if (arg == "--size") {
+            config.payload_bytes = bench::parseSize(value);
+        } else if (arg == "--messages") {
+            config.messages = std::stoull(value);
+        } else if (arg == "--warmup") {
+            config.warmup = std::stoull(value);
+        } else if (arg == "--rate") {
+            config.rate_hz = std::stoull(value);
+        } else if (arg == "--writer-cpu") {
+            config.writer_cpu = std::stoi(value);
+        } else if (arg == "--reader-cpu") {
+            config.reader_cpu = std::stoi(value);
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+
+    if (config.mode != "one-way" && config.mode != "ping-pong") {
+        throw std::invalid_argument("Unknown mode: " + config.mode);
+    }
+    if (config.wait != "futex" && config.wait != "busy" && config.wait != "notify") {
+        throw std::invalid_argument("Unknown wait method: " + config.wait);
+    }
+    if (config.read != "locked" && config.read != "seqlock") {
+        throw std::invalid_argument("Unknown read mode: " + config.read);
+    }
+    if (config.messages == 0) {
+        throw std::invalid_argument("--messages must be positive");
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Config config = parseArgs(argc, argv);
+        json result = run(config);
+
+        const json& latency = result["latency_ns"];
+        std::cerr << "latency_bench " << config.mode << " (" << result["metric"].get<std::string>() << ", "
+                  << config.wait << "): p50=" << latency["p50"] << "ns p99=" << latency["p99"]
+                  << "ns p99.9=" << latency["p99_9"] << "ns max=" << latency["max"] << "ns ("
+                  << result["received"] << " samples)" << std::endl;
+        std::cout << result.dump() << std::endl;
+        return result["ok"].get<bool>() ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
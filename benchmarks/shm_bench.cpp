@@ -0,0 +1,262 @@
+// Throughput and latency benchmark for SharedMemoryJSON.
+//
+// For every combination of payload size, reader process count and read mode,
+// the parent process writes back-to-back for a fixed duration while forked
+// reader processes read back-to-back. One JSON object per combination is
+// printed per line, so results can be collected with e.g. `jq -s`.
+
+#include "shared_memory_json.hpp"
+#include "bench_common.hpp"
+#include "hdr_histogram.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+struct ReaderResult {
+    uint64_t reads;          // Successful read calls
+    uint64_t fresh_reads;    // Reads that returned a sequence not seen before
+    uint64_t failed_reads;   // Read calls that returned false
+    bench::HdrHistogram latency;
+};
+
+struct Control {
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    ReaderResult readers[MAX_READERS];
+};
+
+struct Config {
+    std::vector<uint64_t> sizes = {64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024, 10 * 1024 * 1024};
+    std::vector<uint64_t> readers = {1, 4, 16, 64};
+    std::vector<std::string> modes = {"locked", "seqlock"};
+    uint64_t duration_ms = 1000;
+    std::string output;
+};
+
+// Document whose serialized form is approximately payload_bytes long
+json makePayload(uint64_t payload_bytes) {
+    json doc = {{"seq", 0}, {"blob", ""}};
+    size_t overhead = doc.dump().size() + 10; // Room for the sequence digits
+    doc["blob"] = std::string(payload_bytes > overhead ? payload_bytes - overhead : 0, 'x');
+    return doc;
+}
+
+int readerLoop(const std::string& name, size_t max_size, const std::string& mode, ReaderResult& result, Control& control) {
+    SharedMemoryJSON channel(name, max_size, false);
+    bool seqlock = mode == "seqlock";
+    json data;
+    std::string payload;
+    uint64_t last_seq = 0;
+
+    control.ready.fetch_add(1);
+    while (!control.start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    while (!control.stop.load(std::memory_order_relaxed)) {
+        uint64_t seq = 0;
+        uint64_t ts = 0;
+        uint64_t begin = bench::nowNs();
+        bool ok;
+        if (seqlock) {
+            ok = channel.readSerialized(payload, seq, ts);
+            if (ok) {
+                data = json::parse(payload);
+            }
+        } else {
+            ok = channel.read(data, seq);
+        }
+        uint64_t elapsed = bench::nowNs() - begin;
+
+        if (!ok) {
+            result.failed_reads++;
+            continue;
+        }
+        result.reads++;
+        result.latency.record(elapsed);
+        if (seq > last_seq) {
+            result.fresh_reads++;
+            last_seq = seq;
+        }
+    }
+    return 0;
+}
+
+json runCase(const Config& config, uint64_t payload_bytes, uint64_t reader_count, const std::string& mode) {
+    std::string name = "shm_bench_" + std::to_string(getpid());
+    json doc = makePayload(payload_bytes);
+    size_t serialized_bytes = doc.dump().size();
+    size_t max_size = serialized_bytes + 4096;
+
+    SharedMemoryJSON channel(name, max_size, true);
+    if (!channel.write(doc)) {
+        throw std::runtime_error("Initial write failed: " + channel.getLastError());
+    }
+
+    bench::SharedRegion<Control> control;
+    std::vector<pid_t> children;
+    for (uint64_t i = 0; i < reader_count; ++i) {
+        ReaderResult& result = control->readers[i];
+        children.push_back(bench::spawn([&]() {
+            return readerLoop(name, max_size, mode, result, *control);
+        }));
+    }
+
+    auto ready_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (control->ready.load() < reader_count) {
+        if (std::chrono::steady_clock::now() > ready_deadline) {
+            control->stop = true;
+            control->start = true;
+            bench::waitAll(children);
+            throw std::runtime_error("Reader processes did not start");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bench::HdrHistogram write_latency;
+    uint64_t writes = 0;
+    uint64_t failed_writes = 0;
+
+    control->start.store(true, std::memory_order_release);
+    uint64_t begin = bench::nowNs();
+    uint64_t end = begin + config.duration_ms * 1000000ull;
+    uint64_t now = begin;
+    while (now < end) {
+        doc["seq"] = writes;
+        bool ok = channel.write(doc);
+        uint64_t after = bench::nowNs();
+        if (ok) {
+            writes++;
+            write_latency.record(after - now);
+        } else {
+            failed_writes++;
+        }
+        now = after;
+    }
+    control->stop.store(true);
+    uint64_t elapsed_ns = bench::nowNs() - begin;
+    bool readers_ok = bench::waitAll(children);
+
+    bench::HdrHistogram read_latency;
+    uint64_t reads = 0, fresh_reads = 0, failed_reads = 0;
+    for (uint64_t i = 0; i < reader_count; ++i) {
+        const ReaderResult& result = control->readers[i];
+        reads += result.reads;
+        fresh_reads += result.fresh_reads;
+        failed_reads += result.failed_reads;
+        read_latency.merge(result.latency);
+    }
+
+    double seconds = static_cast<double>(elapsed_ns) / 1e9;
+    double mb = static_cast<double>(serialized_bytes) / (1024.0 * 1024.0);
+    return {
+        {"bench", "shm_bench"},
+        {"payload_bytes", serialized_bytes},
+        {"readers", reader_count},
+        {"mode", mode},
+        {"duration_s", seconds},
+        {"writes", writes},
+        {"failed_writes", failed_writes},
+        {"write_ops_per_sec", writes / seconds},
+        {"write_mb_per_sec", writes * mb / seconds},
+        {"write_latency_ns", write_latency.summary()},
+        {"reads", reads},
+        {"fresh_reads", fresh_reads},
+        {"failed_reads", failed_reads},
+        {"read_ops_per_sec", reads / seconds},
+        {"read_mb_per_sec", reads * mb / seconds},
+        {"read_latency_ns", read_latency.summary()},
+        {"readers_ok", readers_ok}
+    };
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --sizes LIST      Payload sizes, K/M suffixes allowed (default 64,1K,16K,256K,1M,10M)\n"
+              << "  --readers LIST    Reader process counts, 0-" << MAX_READERS << " (default 1,4,16,64)\n"
+              << "  --modes LIST      Read modes: locked, seqlock (default both)\n"
+              << "  --duration MS     Measurement time per case (default 1000)\n"
+              << "  --output FILE     Append results to FILE instead of stdout\n"
+              << "\nExample: " << program << " --sizes 64,1M --readers 1,8 --modes seqlock" << std::endl;
+}
+
+Config parseArgs(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--sizes") {
+            config.sizes = bench::parseSizeList(value);
+        } else if (arg == "--readers") {
+            config.readers.clear();
+            for (const std::string& item : bench::splitList(value)) {
+                config.readers.push_back(std::stoull(item));
+            }
+        } else if (arg == "--modes") {
+            config.modes = bench::splitList(value);
+        } else if (arg == "--duration") {
+            config.duration_ms = std::stoull(value);
+        } else if (arg == "--output") {
+            config.output = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+
+    for (uint64_t readers : config.readers) {
+        if (readers > MAX_READERS) {
+            throw std::invalid_argument("At most " + std::to_string(MAX_READERS) + " reader processes are supported");
+        }
+    }
+    for (const std::string& mode : config.modes) {
+        if (mode != "locked" && mode != "seqlock") {
+            throw std::invalid_argument("Unknown read mode: " + mode);
+        }
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Config config = parseArgs(argc, argv);
+
+        std::ofstream file;
+        if (!config.output.empty()) {
+            file.open(config.output, std::ios::app);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + config.output);
+            }
+        }
+        std::ostream& out = config.output.empty() ? std::cout : file;
+
+        for (uint64_t size : config.sizes) {
+            for (uint64_t readers : config.readers) {
+                for (const std::string& mode : config.modes) {
+                    std::cerr << "shm_bench: payload=" << size << " readers=" << readers
+                              << " mode=" << mode << std::endl;
+                    out << runCase(config, size, readers, mode).dump() << std::endl;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
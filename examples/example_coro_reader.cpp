@@ -0,0 +1,63 @@
+#include "shared_memory_json.hpp"
+#include "shared_memory_coro.hpp"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+// One coroutine per channel, all driven by a single reactor thread
+coro::Task follow(coro::AsyncChannel& channel, std::string name) {
+    uint64_t last_seq = 0;
+    
+    while (true) {
+        auto result = co_await channel.next(last_seq, std::chrono::seconds(5));
+        
+        if (!result) {
+            std::cout << "⏱ [" << name << "] No update for 5 seconds" << std::endl;
+            continue;
+        }
+        if (!result->ok()) {
+            // Skip the unreadable payload and wait for the next one
+            std::cerr << "✗ [" << name << "] " << result->error << std::endl;
+            last_seq = result->sequence ? result->sequence : channel.channel().getSequenceNumber();
+            continue;
+        }
+        
+        last_seq = result->sequence;
+        std::cout << "✓ [" << name << "] seq=" << last_seq
+                  << " " << result->data.dump() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <channel1> [channel2] ..." << std::endl;
+        std::cout << "Example: " << argv[0] << " my_shared_data status_Service1" << std::endl;
+        return 1;
+    }
+    
+    try {
+        coro::Reactor reactor;
+        std::vector<std::unique_ptr<SharedMemoryJSON>> channels;
+        std::vector<std::unique_ptr<coro::AsyncChannel>> async_channels;
+        
+        for (int i = 1; i < argc; ++i) {
+            channels.push_back(std::make_unique<SharedMemoryJSON>(argv[i], 1024 * 1024, false));
+            async_channels.push_back(std::make_unique<coro::AsyncChannel>(reactor, *channels.back()));
+            follow(*async_channels.back(), argv[i]);
+        }
+        
+        std::cout << "Coroutine reader following " << (argc - 1) << " channel(s) on one thread." << std::endl;
+        std::cout << "Press Ctrl+C to stop." << std::endl << std::endl;
+        
+        reactor.run();
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,371 @@
+#include "shared_memory_inspect.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <csignal>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+// Prometheus exporter for channel health.
+//
+// Every scrape walks the channel headers through read-only mappings (see
+// shared_memory_inspect.hpp), so scraping never takes a channel lock and
+// costs the channels nothing. Serves HTTP on a loopback TCP port or on a
+// Unix socket (curl --unix-socket PATH http://localhost/metrics).
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+class MetricsWriter {
+public:
+    // Emits HELP/TYPE once per metric family
+    void family(const std::string& name, const std::string& type, const std::string& help) {
+        out_ << "# HELP " << name << " " << help << "\n";
+        out_ << "# TYPE " << name << " " << type << "\n";
+    }
+
+    void sample(const std::string& name, const std::string& labels, double value) {
+        out_ << name;
+        if (!labels.empty()) {
+            out_ << "{" << labels << "}";
+        }
+        // Counters must stay exact; ostream's default 6 digits would round them
+        if (value == std::floor(value) && std::fabs(value) < 9e15) {
+            out_ << " " << static_cast<long long>(value) << "\n";
+        } else {
+            out_ << " " << std::setprecision(9) << value << "\n";
+        }
+    }
+
+    std::string str() const {
+        return out_.str();
+    }
+
+private:
+    std::ostringstream out_;
+};
+
+class Exporter {
+public:
+    Exporter(std::string directory, std::vector<std::string> filter)
+        : directory_(std::move(directory))
+        , filter_(std::move(filter))
+    {
+    }
+
+    std::string render() {
+        std::vector<ChannelInfo> channels;
+        if (filter_.empty()) {
+            channels = listChannels(directory_.empty() ? "/dev/shm" : directory_);
+        } else {
+            // Names containing '/' are paths of channel files, e.g. backing files
+            for (const std::string& name : filter_) {
+                ChannelInfo info;
+                std::string error;
+                bool ok = name.find('/') != std::string::npos ? inspectChannelFile(name, info, error)
+                                                              : inspectChannel(name, info, error, directory_);
+                if (ok) {
+                    channels.push_back(info);
+                }
+            }
+        }
+
+        MetricsWriter metrics;
+        metrics.family("shm_exporter_channels", "gauge", "Channels found during this scrape");
+        metrics.sample("shm_exporter_channels", "", static_cast<double>(channels.size()));
+
+        gauge(metrics, channels, "shm_channel_compatible", "1 if the channel uses this exporter's protocol version",
+              [](const ChannelInfo& c) { return c.compatible ? 1.0 : 0.0; }, true);
+        gauge(metrics, channels, "shm_channel_region_bytes", "Size of the shared memory region",
+              [](const ChannelInfo& c) { return static_cast<double>(c.region_bytes); }, true);
+        gauge(metrics, channels, "shm_channel_data_bytes", "Size of the current payload",
+              [](const ChannelInfo& c) { return static_cast<double>(c.data_size); });
+        gauge(metrics, channels, "shm_channel_sequence", "Sequence number of the current payload",
+              [](const ChannelInfo& c) { return static_cast<double>(c.sequence); });
+        gauge(metrics, channels, "shm_channel_last_write_age_seconds", "Time since the last write (publisher lag)",
+              [](const ChannelInfo& c) { return c.age_us / 1e6; });
+        gauge(metrics, channels, "shm_channel_readers", "Attached reader processes that are alive",
+              [](const ChannelInfo& c) { return static_cast<double>(c.readers); });
+        gauge(metrics, channels, "shm_channel_notify_subscribers", "Registered notify fd subscribers",
+              [](const ChannelInfo& c) { return static_cast<double>(c.notify_subscribers); });
+        gauge(metrics, channels, "shm_channel_waiters", "Processes blocked waiting for an update",
+              [](const ChannelInfo& c) { return static_cast<double>(c.waiters); });
+
+        counter(metrics, channels, "shm_channel_writes_total", "Successful writes",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.writes); });
+        counter(metrics, channels, "shm_channel_written_bytes_total", "Serialized bytes published",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.bytes_written); });
+        counter(metrics, channels, "shm_channel_reads_total", "Successful reads",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.reads); });
+        counter(metrics, channels, "shm_channel_failed_reads_total", "Reads that returned false",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.failed_reads); });
+        counter(metrics, channels, "shm_channel_lock_acquisitions_total", "Channel lock acquisitions",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.lock_acquisitions); });
+        counter(metrics, channels, "shm_channel_lock_contended_total", "Lock acquisitions that had to block",
+                [](const ChannelInfo& c) { return static_cast<double>(c.stats.contended_acquisitions); });
+        counter(metrics, channels, "shm_channel_lock_blocked_seconds_total", "Time spent blocked on the channel lock",
+                [](const ChannelInfo& c) { return c.stats.lock_wait_ns / 1e9; });
+
+        lockHistograms(metrics, channels);
+        return metrics.str();
+    }
+
+private:
+    std::string directory_;
+    std::vector<std::string> filter_;
+
+    template <typename Value>
+    static void gauge(MetricsWriter& metrics, const std::vector<ChannelInfo>& channels, const std::string& name,
+                      const std::string& help, Value value, bool include_incompatible = false) {
+        emit(metrics, channels, name, "gauge", help, value, include_incompatible);
+    }
+
+    template <typename Value>
+    static void counter(MetricsWriter& metrics, const std::vector<ChannelInfo>& channels, const std::string& name,
+                        const std::string& help, Value value) {
+        emit(metrics, channels, name, "counter", help, value, false);
+    }
+
+    template <typename Value>
+    static void emit(MetricsWriter& metrics, const std::vector<ChannelInfo>& channels, const std::string& name,
+                     const std::string& type, const std::string& help, Value value, bool include_incompatible) {
+        metrics.family(name, type, help);
+        for (const ChannelInfo& info : channels) {
+            if (info.compatible || include_incompatible) {
+                metrics.sample(name, "channel=\"" + escapeLabel(info.name) + "\"", value(info));
+            }
+        }
+    }
+
+    // Lock wait/hold histograms for channels with lock profiling enabled
+    static void lockHistograms(MetricsWriter& metrics, const std::vector<ChannelInfo>& channels) {
+        const char* kinds[] = {"wait", "hold"};
+        for (const char* kind : kinds) {
+            std::string name = std::string("shm_channel_lock_") + kind + "_seconds";
+            metrics.family(name, "histogram", std::string("Lock ") + kind + " time per operation (lock profiling only)");
+            for (const ChannelInfo& info : channels) {
+                if (!info.compatible || !info.lock_profile.enabled) {
+                    continue;
+                }
+                const std::pair<const char*, const LockOpProfile*> ops[] = {
+                    {"write", &info.lock_profile.write},
+                    {"read", &info.lock_profile.read},
+                    {"query", &info.lock_profile.query}};
+                for (const auto& op : ops) {
+                    bool wait = kind[0] == 'w';
+                    const auto& buckets = wait ? op.second->wait_histogram : op.second->hold_histogram;
+                    std::string labels = "channel=\"" + escapeLabel(info.name) + "\",op=\"" + op.first + "\"";
+
+                    uint64_t cumulative = 0;
+                    for (size_t i = 0; i + 1 < LOCK_HISTOGRAM_BUCKETS; ++i) {
+                        cumulative += buckets[i];
+                        std::ostringstream le;
+                        le << static_cast<double>(uint64_t(2) << i) / 1e9;
+                        metrics.sample(name + "_bucket", labels + ",le=\"" + le.str() + "\"", static_cast<double>(cumulative));
+                    }
+                    cumulative += buckets[LOCK_HISTOGRAM_BUCKETS - 1];
+                    metrics.sample(name + "_bucket", labels + ",le=\"+Inf\"", static_cast<double>(cumulative));
+                    uint64_t total_ns = wait ? op.second->total_wait_ns : op.second->total_hold_ns;
+                    metrics.sample(name + "_sum", labels, total_ns / 1e9);
+                    metrics.sample(name + "_count", labels, static_cast<double>(cumulative));
+                }
+            }
+        }
+    }
+};
+
+class HttpServer {
+public:
+    // TCP on 127.0.0.1:port
+    explicit HttpServer(uint16_t port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ == -1) {
+            throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+        }
+        int yes = 1;
+        setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bindAndListen(reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    }
+
+    // Unix domain socket at path
+    explicit HttpServer(const std::string& path)
+        : unix_path_(path)
+    {
+        fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ == -1) {
+            throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+        }
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            close(fd_);
+            throw std::runtime_error("Unix socket path too long: " + path);
+        }
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str()); // Stale socket from a previous run
+        bindAndListen(reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    }
+
+    ~HttpServer() {
+        close(fd_);
+        if (!unix_path_.empty()) {
+            unlink(unix_path_.c_str());
+        }
+    }
+
+    /**
+     * Serve one request if a client connects within timeout_ms
+     */
+    template <typename Handler>
+    void serveOnce(int timeout_ms, Handler handler) {
+        pollfd pfd = {fd_, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) <= 0) {
+            return;
+        }
+        int client = accept(fd_, nullptr, nullptr);
+        if (client == -1) {
+            return;
+        }
+
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            pollfd cfd = {client, POLLIN, 0};
+            if (poll(&cfd, 1, 1000) <= 0) {
+                break;
+            }
+            ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(n));
+        }
+
+        std::string status = "200 OK";
+        std::string body;
+        if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 14, "GET /metrics? ") == 0) {
+            body = handler();
+        } else if (request.compare(0, 6, "GET / ") == 0) {
+            body = "Shared memory channel exporter - see /metrics\n";
+        } else {
+            status = "404 Not Found";
+            body = "Not found\n";
+        }
+
+        std::string response = "HTTP/1.1 " + status + "\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        close(client);
+    }
+
+private:
+    int fd_ = -1;
+    std::string unix_path_;
+
+    void bindAndListen(const sockaddr* addr, socklen_t len) {
+        if (bind(fd_, addr, len) == -1 || listen(fd_, 16) == -1) {
+            std::string error = strerror(errno);
+            close(fd_);
+            throw std::runtime_error("Failed to listen: " + error);
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint16_t port = 9464;
+    std::string unix_path;
+    std::string directory;         // Empty = POSIX shared memory (listed from /dev/shm)
+    std::vector<std::string> channels;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--unix" && i + 1 < argc) {
+            unix_path = argv[++i];
+        } else if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--port N | --unix PATH] [--dir DIR] [channel | path...]" << std::endl;
+            std::cout << "  --dir DIR  Directory holding the channels as files, e.g. backing files" << std::endl;
+            std::cout << "Example: " << argv[0] << " --port 9464" << std::endl;
+            std::cout << "         curl http://127.0.0.1:9464/metrics" << std::endl;
+            return 0;
+        } else {
+            channels.push_back(arg);
+        }
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    try {
+        Exporter exporter(directory, channels);
+        std::unique_ptr<HttpServer> server = unix_path.empty()
+            ? std::make_unique<HttpServer>(port)
+            : std::make_unique<HttpServer>(unix_path);
+
+        if (unix_path.empty()) {
+            std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+        } else {
+            std::cout << "Serving metrics on unix:" << unix_path << " (path /metrics)" << std::endl;
+        }
+        std::cout << (channels.empty() ? "Exporting all channels in " + (directory.empty() ? "/dev/shm" : directory)
+                                       : "Exporting " + std::to_string(channels.size()) + " channel(s)") << std::endl;
+        std::cout << "Press Ctrl+C to stop.\n" << std::endl;
+
+        while (!g_stop) {
+            server->serveOnce(500, [&exporter]() { return exporter.render(); });
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "shared_memory_json.hpp"
+#include "shared_memory_channel_set.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -27,22 +28,27 @@ public:
         std::cout << "\n=== Service Monitor ===" << std::endl;
         std::cout << "Press Ctrl+C to stop.\n" << std::endl;
         
+        // Wait on all services at once so latency doesn't grow with the service count
+        ChannelSet channels;
+        std::vector<std::string> names;
+        for (auto& [name, info] : services_) {
+            channels.add(*info.shm, info.last_seq);
+            names.push_back(name);
+        }
+        
         while (true) {
-            bool any_update = false;
-            
-            for (auto& [name, info] : services_) {
+            for (size_t index : channels.waitAny(1000)) {
                 json status;
+                uint64_t seq;
                 
-                if (info.shm->readWithTimeout(status, 100, info.last_seq)) {
-                    info.last_seq = info.shm->getSequenceNumber();
-                    displayStatus(name, status);
-                    any_update = true;
+                // A write landing after waitAny() is read here already; its own
+                // wakeup must not display it a second time
+                ServiceInfo& info = services_[names[index]];
+                if (channels.channel(index).read(status, seq) && seq > info.last_seq) {
+                    info.last_seq = seq;
+                    displayStatus(names[index], status);
                 }
             }
-            
-            if (!any_update) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
         }
     }
     
@@ -50,16 +56,28 @@ public:
         std::cout << "\n=== Current Status Snapshot ===" << std::endl;
         std::cout << std::string(80, '=') << std::endl;
         
+        // Capture every service at the same moment, then display
+        ChannelSet channels;
+        std::vector<std::string> names;
         for (auto& [name, info] : services_) {
-            json status;
+            channels.add(*info.shm);
+            names.push_back(name);
+        }
+        
+        Snapshot snapshot = channels.snapshot();
+        
+        for (size_t i = 0; i < names.size(); ++i) {
+            const ChannelSnapshot& entry = snapshot.channels[i];
             
-            if (info.shm->read(status)) {
-                displayStatus(name, status);
+            if (entry.valid) {
+                displayStatus(names[i], entry.data);
             } else {
-                std::cout << "\n[" << name << "] No data available" << std::endl;
+                std::cout << "\n[" << names[i] << "] No data available" << std::endl;
             }
         }
         
+        std::cout << "\nCaptured " << names.size() << " service(s) in "
+                  << snapshot.capture_ns / 1000.0 << " µs" << std::endl;
         std::cout << std::string(80, '=') << std::endl;
     }
 
@@ -52,6 +52,12 @@ private:
     bool running_ = true;
     std::chrono::steady_clock::time_point last_status_update_ = 
         std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_status_write_;
+    bool status_written_ = false;
+    
+    // Without readers the status is still refreshed this often, so a reader
+    // that attaches and reads at once (monitor --snapshot) finds recent data
+    static constexpr std::chrono::seconds STATUS_KEEPALIVE{10};
     
     // Simulate some service state
     double temperature_ = 20.0;
@@ -85,6 +91,13 @@ private:
     }
     
     void publishStatus(int counter) {
+        // Nobody is monitoring this service - skip building and serializing the
+        // status, apart from the first one and a low-rate keepalive
+        auto now = std::chrono::steady_clock::now();
+        if (status_written_ && now - last_status_write_ < STATUS_KEEPALIVE && !status_.hasActiveReaders()) {
+            return;
+        }
+        
         // Add some random variation to temperature
         static std::random_device rd;
         static std::mt19937 gen(rd());
@@ -107,6 +120,8 @@ private:
         };
         
         if (status_.write(status)) {
+            status_written_ = true;
+            last_status_write_ = now;
             std::cout << "[" << name_ << "] Status published (counter=" 
                       << counter << ")" << std::endl;
         }
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * Pipelined writer that moves serialization off the caller's thread.
+ *
+ * writeAsync() moves the document into a queue and returns immediately; a
+ * background thread runs dump(), lock, memcpy and unlock, then completes the
+ * returned future with the sequence number the document was published at.
+ * Documents are written in the order they were enqueued.
+ */
+class AsyncWriter {
+public:
+    /**
+     * Constructor
+     * @param channel Channel written by the background thread (must outlive the writer)
+     */
+    explicit AsyncWriter(SharedMemoryJSON& channel)
+        : channel_(channel)
+    {
+        thread_ = std::thread([this]() { writeLoop(); });
+    }
+
+    /**
+     * Destructor - writes everything still queued, then stops the background thread
+     */
+    ~AsyncWriter() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    // Prevent copying
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * Queue a document for writing
+     * @param data Document to write; moved from, never copied
+     * @return Future holding the assigned sequence number, or a std::runtime_error
+     *         with the channel's error message if the write fails
+     */
+    std::future<uint64_t> writeAsync(json&& data) {
+        std::promise<uint64_t> promise;
+        std::future<uint64_t> future = promise.get_future();
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            was_empty = queue_.empty();
+            queue_.push_back({std::move(data), std::move(promise)});
+        }
+        if (was_empty) {
+            cv_.notify_one();
+        }
+        return future;
+    }
+
+    /**
+     * Number of documents queued but not yet written
+     */
+    size_t pending() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return queue_.size() + in_flight_;
+    }
+
+private:
+    struct Request {
+        json data;
+        std::promise<uint64_t> promise;
+    };
+
+    SharedMemoryJSON& channel_;
+    std::deque<Request> queue_;
+    size_t in_flight_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void writeLoop() {
+        std::deque<Request> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(mutex_);
+                in_flight_ = 0;
+                cv_.wait(guard, [this]() { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return; // Stopping and fully drained
+                }
+                // Take the whole queue at once so producers contend on the mutex once per batch
+                batch.swap(queue_);
+                in_flight_ = batch.size();
+            }
+
+            for (Request& request : batch) {
+                uint64_t sequence;
+                if (channel_.write(request.data, sequence)) {
+                    request.promise.set_value(sequence);
+                } else {
+                    request.promise.set_exception(std::make_exception_ptr(
+                        std::runtime_error(channel_.getLastError())));
+                }
+            }
+            batch.clear();
+        }
+    }
+};
+
+} // namespace shared_memory
@@ -0,0 +1,858 @@
+#pragma once
+
+// Mirror a channel over a stream socket (Unix domain or TCP), for consumers
+// that cannot map the writer's /dev/shm, e.g. in another container (POSIX only).
+//
+// A connection starts with a HELLO frame from the sender, followed by one
+// frame per forwarded update. Every frame is a BridgeFrameHeader and a body
+// of `length` bytes:
+//
+//   HELLO  JSON object {"version", "channel", "max_size", "sequence"}
+//   FULL   the serialized payload as published
+//   DELTA  a JSON Patch (RFC 6902) against the document of the previous frame
+//
+// A body flagged BRIDGE_FLAG_COMPRESSED is a zlib stream inflating to
+// raw_length bytes. Header fields are in host byte order, so both ends must
+// share it (same machine or architecture).
+
+#include "shared_memory_json.hpp"
+
+#ifdef _WIN32
+#error "shared_memory_bridge.hpp requires POSIX sockets"
+#endif
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+
+#ifdef SHM_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace shared_memory {
+
+constexpr uint32_t BRIDGE_MAGIC = 0x47445242;  // "BRDG"
+constexpr uint32_t BRIDGE_VERSION = 1;
+constexpr uint8_t BRIDGE_FLAG_COMPRESSED = 1;
+
+enum class BridgeFrameType : uint8_t {
+    Hello = 1,
+    Full = 2,
+    Delta = 3
+};
+
+struct BridgeFrameHeader {
+    uint32_t magic;
+    uint8_t type;                          // BridgeFrameType
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t length;                       // Body bytes on the wire
+    uint32_t raw_length;                   // Body bytes after decompression
+    uint64_t sequence;                     // Channel sequence of the update
+    uint64_t timestamp;                    // Write time in the channel (microseconds since epoch)
+};
+static_assert(sizeof(BridgeFrameHeader) == 32, "BridgeFrameHeader must stay 32 bytes");
+
+/**
+ * First frame of a connection, describing the sender's channel
+ */
+struct BridgeHello {
+    uint32_t version = 0;
+    std::string channel;
+    uint64_t max_size = 0;
+    uint64_t sequence = 0;                 // Sender's sequence number when the connection opened
+};
+
+struct BridgeOptions {
+    bool deltas = false;                   // Send JSON Patch deltas when smaller than the payload
+    uint32_t full_every = 100;             // Send a full payload after this many deltas in a row
+    uint64_t batch_delay_ms = 0;           // Collect updates this long per send (0 = send each at once)
+    size_t batch_bytes = 64 * 1024;        // Send a batch early once it holds this many bytes
+    bool compress = false;                 // zlib-compress frame bodies (needs SHM_ENABLE_ZLIB)
+    int compress_level = 1;
+    size_t compress_min_bytes = 512;       // Smaller bodies are sent uncompressed
+    uint64_t wait_timeout_ms = 100;        // Longest sleep between checks for stop()
+    uint64_t send_timeout_ms = 10000;      // Drop a peer that accepts no data for this long (0 = never)
+};
+
+struct BridgeStats {
+    uint64_t frames = 0;                   // Update frames sent or received
+    uint64_t full_frames = 0;
+    uint64_t delta_frames = 0;
+    uint64_t compressed_frames = 0;
+    uint64_t batches = 0;                  // Sender: send() calls
+    uint64_t payload_bytes = 0;            // Serialized payload bytes the frames carried
+    uint64_t wire_bytes = 0;               // Frame bytes on the socket, headers included
+    uint64_t skipped = 0;                  // Sender: sequences overwritten before they were sent;
+                                           // receiver: frames at or below the local sequence
+    uint64_t failed = 0;                   // Sender: failed snapshots; receiver: failed republishes
+    uint64_t last_sequence = 0;            // Last sequence sent or published
+};
+
+namespace detail {
+
+// Whether a transfer that last made progress at last_progress has stalled for timeout_ms (0 = never)
+inline bool transferStalled(std::chrono::steady_clock::time_point last_progress, uint64_t timeout_ms) {
+    return timeout_ms != 0 &&
+           std::chrono::steady_clock::now() - last_progress >= std::chrono::milliseconds(timeout_ms);
+}
+
+// Send exactly size bytes, checking stopping between polls; false on error, stop or a
+// peer that accepted nothing for timeout_ms (0 = no limit)
+inline bool sendAll(int fd, const char* data, size_t size, const std::atomic<bool>& stopping, std::string& error,
+                    uint64_t timeout_ms = 0, int poll_ms = 100) {
+    auto last_progress = std::chrono::steady_clock::now();
+    while (size > 0) {
+        if (stopping.load(std::memory_order_relaxed)) {
+            error = "Stopped";
+            return false;
+        }
+        if (transferStalled(last_progress, timeout_ms)) {
+            error = "Send timed out";
+            return false;
+        }
+        pollfd entry = {fd, POLLOUT, 0};
+        int ready = ::poll(&entry, 1, poll_ms);
+        if (ready == 0 || (ready == -1 && errno == EINTR)) {
+            continue;
+        }
+        ssize_t sent = ready == -1 ? -1 : ::send(fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent == -1) {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+                continue;
+            }
+            error = std::string("Send failed: ") + strerror(errno);
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+        last_progress = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+
+// Receive exactly size bytes, checking stopping between polls; false on EOF, error, stop
+// or a peer that sent nothing for timeout_ms (0 = no limit)
+inline bool recvAll(int fd, void* buffer, size_t size, const std::atomic<bool>& stopping, std::string& error,
+                    uint64_t timeout_ms = 0, int poll_ms = 100) {
+    char* data = static_cast<char*>(buffer);
+    auto last_progress = std::chrono::steady_clock::now();
+    while (size > 0) {
+        if (stopping.load(std::memory_order_relaxed)) {
+            error = "Stopped";
+            return false;
+        }
+        if (transferStalled(last_progress, timeout_ms)) {
+            error = "Receive timed out";
+            return false;
+        }
+        pollfd entry = {fd, POLLIN, 0};
+        int ready = ::poll(&entry, 1, poll_ms);
+        if (ready == 0 || (ready == -1 && errno == EINTR)) {
+            continue;
+        }
+        ssize_t received = ready == -1 ? -1 : ::recv(fd, data, size, 0);
+        if (received == 0) {
+            error = "Connection closed";
+            return false;
+        }
+        if (received == -1) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            error = std::string("Receive failed: ") + strerror(errno);
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+        last_progress = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+
+#ifdef SHM_ENABLE_ZLIB
+inline bool zlibCompress(const std::string& input, std::string& output, int level) {
+    uLongf size = compressBound(static_cast<uLong>(input.size()));
+    output.resize(size);
+    if (compress2(reinterpret_cast<Bytef*>(&output[0]), &size, reinterpret_cast<const Bytef*>(input.data()),
+                  static_cast<uLong>(input.size()), level) != Z_OK) {
+        return false;
+    }
+    output.resize(size);
+    return true;
+}
+
+inline bool zlibDecompress(const std::string& input, std::string& output, size_t raw_length) {
+    output.resize(raw_length);
+    uLongf size = static_cast<uLongf>(raw_length);
+    return uncompress(reinterpret_cast<Bytef*>(&output[0]), &size, reinterpret_cast<const Bytef*>(input.data()),
+                      static_cast<uLong>(input.size())) == Z_OK && size == raw_length;
+}
+#endif
+
+// Split "unix:/path", "tcp:host:port" or "host:port"
+inline bool parseBridgeAddress(const std::string& address, bool& is_unix, std::string& host, std::string& port) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        is_unix = true;
+        host = address.substr(5);
+        return !host.empty() && host.size() < sizeof(sockaddr_un::sun_path);
+    }
+    is_unix = false;
+    std::string rest = address.compare(0, 4, "tcp:") == 0 ? address.substr(4) : address;
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos || colon + 1 == rest.size()) {
+        return false;
+    }
+    host = rest.substr(0, colon);
+    port = rest.substr(colon + 1);
+    return true;
+}
+
+inline void setNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails harmlessly on Unix sockets
+}
+
+// Create a socket for address and bind (listen=true) or connect it
+inline int openBridgeSocket(const std::string& address, bool listen, std::string& error) {
+    bool is_unix;
+    std::string host, port;
+    if (!parseBridgeAddress(address, is_unix, host, port)) {
+        error = "Invalid address " + address + " (expected unix:/path or [tcp:]host:port)";
+        return -1;
+    }
+
+    if (is_unix) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            error = std::string("Failed to create socket: ") + strerror(errno);
+            return -1;
+        }
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, host.c_str(), sizeof(addr.sun_path) - 1);
+        if (listen) {
+            ::unlink(host.c_str()); // Stale socket of a previous run
+        }
+        int result = listen ? ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+                            : ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        if (result == -1 || (listen && ::listen(fd, 16) == -1)) {
+            error = "Failed to " + std::string(listen ? "listen on " : "connect to ") + address + ": " + strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listen ? AI_PASSIVE : 0;
+    addrinfo* results = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &results);
+    if (status != 0) {
+        error = "Failed to resolve " + address + ": " + gai_strerror(status);
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* candidate = results; candidate; candidate = candidate->ai_next) {
+        fd = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (fd == -1) {
+            continue;
+        }
+        if (listen) {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (::bind(fd, candidate->ai_addr, candidate->ai_addrlen) == 0 && ::listen(fd, 16) == 0) {
+                break;
+            }
+        } else if (::connect(fd, candidate->ai_addr, candidate->ai_addrlen) == 0) {
+            setNoDelay(fd);
+            break;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    if (fd == -1) {
+        error = "Failed to " + std::string(listen ? "listen on " : "connect to ") + address + ": " + strerror(errno);
+    }
+    freeaddrinfo(results);
+    return fd;
+}
+
+} // namespace detail
+
+/**
+ * Listen for bridge connections
+ * @param address "unix:/path/to/socket", "tcp:host:port" or "host:port"
+ * @param error Output parameter for the reason of a failure
+ * @return Listening socket, or -1 on failure
+ */
+inline int bridgeListen(const std::string& address, std::string& error) {
+    return detail::openBridgeSocket(address, true, error);
+}
+
+/**
+ * Accept a bridge connection
+ * @param listen_fd Socket from bridgeListen()
+ * @param timeout_ms Give up after this many milliseconds
+ * @param error Output parameter for the reason of a failure (empty on timeout)
+ * @return Connected socket, or -1 on timeout or failure
+ */
+inline int bridgeAccept(int listen_fd, uint64_t timeout_ms, std::string& error) {
+    error.clear();
+    pollfd entry = {listen_fd, POLLIN, 0};
+    int ready = ::poll(&entry, 1, static_cast<int>(timeout_ms));
+    if (ready <= 0) {
+        if (ready == -1 && errno != EINTR) {
+            error = std::string("Poll failed: ") + strerror(errno);
+        }
+        return -1;
+    }
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd == -1) {
+        error = std::string("Accept failed: ") + strerror(errno);
+        return -1;
+    }
+    detail::setNoDelay(fd);
+    return fd;
+}
+
+/**
+ * Connect to a bridge sender
+ * @param address Address the sender listens on (see bridgeListen())
+ * @param error Output parameter for the reason of a failure
+ * @return Connected socket, or -1 on failure
+ */
+inline int bridgeConnect(const std::string& address, std::string& error) {
+    return detail::openBridgeSocket(address, false, error);
+}
+
+/**
+ * Forwards a channel's updates over a connected stream socket.
+ *
+ * A background thread follows the channel by sequence number, copies each
+ * update with the lock-free readSerialized() and sends it as a frame. Like
+ * any reader it only sees the latest value: updates overwritten before they
+ * were copied are counted in BridgeStats::skipped. With deltas, a JSON Patch
+ * is sent instead of the payload whenever it is smaller; this costs a parse
+ * and a diff per update on the sending side. With a batch delay, updates
+ * arriving within the delay share one send() call.
+ */
+class BridgeSender {
+public:
+    /**
+     * Constructor - sends the HELLO frame
+     * @param channel Channel to forward (must outlive the sender and not be used
+     *        by other threads, e.g. a second instance opened with create=false)
+     * @param fd Connected stream socket (owned by the caller, who closes it after stop())
+     * @param options Deltas, batching, compression and the send timeout
+     * @throws std::runtime_error if compression is requested without zlib support or the HELLO cannot be sent
+     */
+    BridgeSender(SharedMemoryJSON& channel, int fd, BridgeOptions options = BridgeOptions())
+        : channel_(channel)
+        , fd_(fd)
+        , options_(options)
+    {
+#ifndef SHM_ENABLE_ZLIB
+        if (options_.compress) {
+            throw std::runtime_error("Bridge compression needs a build with SHM_ENABLE_ZLIB");
+        }
+#endif
+        json hello = {{"version", BRIDGE_VERSION}, {"channel", channel_.getName()},
+                      {"max_size", channel_.getMaxDataSize()}, {"sequence", channel_.getSequenceNumber()}};
+        std::string body = hello.dump();
+        appendFrame(BridgeFrameType::Hello, 0, 0, body);
+        std::string error;
+        if (!flush(error)) {
+            throw std::runtime_error("Failed to send bridge hello: " + error);
+        }
+    }
+
+    ~BridgeSender() {
+        stop();
+    }
+
+    // Prevent copying
+    BridgeSender(const BridgeSender&) = delete;
+    BridgeSender& operator=(const BridgeSender&) = delete;
+
+    /**
+     * Start forwarding on a background thread
+     * @param last_seq Sequence number the far side already has (0 to include the current data)
+     */
+    void start(uint64_t last_seq = 0) {
+        if (running_) {
+            return;
+        }
+        last_seq_ = last_seq;
+        stopping_ = false;
+        running_ = true;
+        thread_ = std::thread([this]() { sendLoop(); });
+    }
+
+    /**
+     * Stop the background thread
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+        thread_.join();
+        running_ = false;
+    }
+
+    /**
+     * Whether the connection is still usable (false once a send failed, the
+     * peer accepted no data for BridgeOptions::send_timeout_ms, or the source
+     * channel was replaced by a restarted writer)
+     *
+     * @note After a source restart the caller reopens the channel and connects
+     *       a new sender; the receiver on the far side then continues above its
+     *       local sequence (see BridgeReceiver).
+     */
+    bool isConnected() const {
+        return connected_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Counters since construction (safe to call while running)
+     */
+    BridgeStats getStats() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return stats_;
+    }
+
+    /**
+     * Last snapshot or socket error
+     */
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return last_error_;
+    }
+
+private:
+    SharedMemoryJSON& channel_;
+    int fd_;
+    BridgeOptions options_;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> connected_{true};
+    bool running_ = false;
+    uint64_t last_seq_ = 0;
+
+    std::string payload_;
+    std::string delta_;
+    std::string compressed_;
+    std::string batch_;                    // Frames waiting for the next send()
+    json previous_;                        // Document of the last frame (deltas only)
+    bool have_previous_ = false;
+    uint32_t deltas_in_row_ = 0;
+
+    mutable std::mutex stats_mutex_;
+    BridgeStats stats_;
+    std::string last_error_;
+
+    void sendLoop() {
+        auto last_source_check = std::chrono::steady_clock::now();
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            // A restarted writer unlinks the region this sender is mapped to,
+            // which then never changes again
+            if (std::chrono::steady_clock::now() - last_source_check >= std::chrono::seconds(1)) {
+                last_source_check = std::chrono::steady_clock::now();
+                if (channel_.isReplaced()) {
+                    std::lock_guard<std::mutex> guard(stats_mutex_);
+                    last_error_ = "Source channel was replaced";
+                    connected_ = false;
+                    return;
+                }
+            }
+            if (!channel_.waitForUpdate(last_seq_, options_.wait_timeout_ms)) {
+                continue;
+            }
+            addUpdate();
+
+            if (options_.batch_delay_ms > 0) {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.batch_delay_ms);
+                while (batch_.size() < options_.batch_bytes && !stopping_.load(std::memory_order_relaxed)) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now()).count();
+                    if (remaining <= 0) {
+                        break;
+                    }
+                    if (channel_.waitForUpdate(last_seq_, static_cast<uint64_t>(remaining))) {
+                        addUpdate();
+                    }
+                }
+            }
+
+            std::string error;
+            if (!batch_.empty() && !flush(error)) {
+                std::lock_guard<std::mutex> guard(stats_mutex_);
+                last_error_ = error;
+                connected_ = false;
+                return;
+            }
+        }
+    }
+
+    // Copy the current payload and append it as a FULL or DELTA frame
+    void addUpdate() {
+        uint64_t sequence, timestamp;
+        if (!channel_.readSerialized(payload_, sequence, timestamp)) {
+            // Don't spin on an unreadable payload; wait for the next write
+            last_seq_ = channel_.getSequenceNumber();
+            std::lock_guard<std::mutex> guard(stats_mutex_);
+            stats_.failed++;
+            last_error_ = "Snapshot failed: " + channel_.getLastError();
+            return;
+        }
+        if (sequence <= last_seq_) {
+            return;
+        }
+        uint64_t skipped = last_seq_ != 0 && sequence > last_seq_ + 1 ? sequence - last_seq_ - 1 : 0;
+        last_seq_ = sequence;
+
+        BridgeFrameType type = BridgeFrameType::Full;
+        if (options_.deltas) {
+            json current = json::parse(payload_, nullptr, false);
+            if (current.is_discarded()) {
+                have_previous_ = false;
+            } else {
+                if (have_previous_ && deltas_in_row_ < options_.full_every) {
+                    delta_ = json::diff(previous_, current).dump();
+                    if (delta_.size() < payload_.size()) {
+                        type = BridgeFrameType::Delta;
+                    }
+                }
+                previous_ = std::move(current);
+                have_previous_ = true;
+            }
+            deltas_in_row_ = type == BridgeFrameType::Delta ? deltas_in_row_ + 1 : 0;
+        }
+
+        bool compressed = appendFrame(type, sequence, timestamp, type == BridgeFrameType::Delta ? delta_ : payload_);
+
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        stats_.frames++;
+        (type == BridgeFrameType::Delta ? stats_.delta_frames : stats_.full_frames)++;
+        stats_.compressed_frames += compressed ? 1 : 0;
+        stats_.payload_bytes += payload_.size();
+        stats_.skipped += skipped;
+        stats_.last_sequence = sequence;
+    }
+
+    // Append a frame to the batch; returns whether the body was compressed
+    bool appendFrame(BridgeFrameType type, uint64_t sequence, uint64_t timestamp, const std::string& body) {
+        const std::string* wire = &body;
+        uint8_t flags = 0;
+#ifdef SHM_ENABLE_ZLIB
+        if (options_.compress && body.size() >= options_.compress_min_bytes &&
+            detail::zlibCompress(body, compressed_, options_.compress_level) && compressed_.size() < body.size()) {
+            wire = &compressed_;
+            flags |= BRIDGE_FLAG_COMPRESSED;
+        }
+#endif
+        BridgeFrameHeader header = {};
+        header.magic = BRIDGE_MAGIC;
+        header.type = static_cast<uint8_t>(type);
+        header.flags = flags;
+        header.length = static_cast<uint32_t>(wire->size());
+        header.raw_length = static_cast<uint32_t>(body.size());
+        header.sequence = sequence;
+        header.timestamp = timestamp;
+        batch_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        batch_.append(*wire);
+        return flags != 0;
+    }
+
+    bool flush(std::string& error) {
+        bool ok = detail::sendAll(fd_, batch_.data(), batch_.size(), stopping_, error, options_.send_timeout_ms,
+                                  static_cast<int>(options_.wait_timeout_ms));
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        stats_.batches++;
+        stats_.wire_bytes += batch_.size();
+        batch_.clear();
+        return ok;
+    }
+};
+
+/**
+ * Republishes the updates of a BridgeSender into a local channel.
+ *
+ * A background thread reads frames from the socket, rebuilds each payload
+ * (applying deltas to the previous document) and publishes it with
+ * republish(), so local readers see the sender's sequence numbers and write
+ * timestamps. Frames at or below the local sequence number, e.g. the
+ * current data resent after a reconnect, are skipped. If the sender's
+ * channel restarted below the local sequence number, its sequence numbers
+ * are shifted up by a fixed offset, so local readers keep seeing increasing
+ * numbers and the mirror follows the restarted channel at once. Payloads
+ * rebuilt from deltas are re-serialized and may differ in formatting from
+ * the original.
+ */
+class BridgeReceiver {
+public:
+    /**
+     * Read the HELLO frame that opens a connection
+     * @param fd Connected stream socket
+     * @param hello Output parameter for the sender's channel description
+     * @param error Output parameter for the reason of a failure
+     * @param timeout_ms Give up once the sender sent nothing for this many milliseconds
+     * @return true if a valid HELLO of a supported version was received
+     */
+    static bool readHello(int fd, BridgeHello& hello, std::string& error, uint64_t timeout_ms = 5000) {
+        std::atomic<bool> never{false};
+        pollfd entry = {fd, POLLIN, 0};
+        if (::poll(&entry, 1, static_cast<int>(timeout_ms)) <= 0) {
+            error = "No hello from bridge sender";
+            return false;
+        }
+        BridgeFrameHeader header;
+        if (!detail::recvAll(fd, &header, sizeof(header), never, error, timeout_ms)) {
+            return false;
+        }
+        if (header.magic != BRIDGE_MAGIC || header.type != static_cast<uint8_t>(BridgeFrameType::Hello) ||
+            header.flags != 0 || header.length > 4096) {
+            error = "Not a bridge hello";
+            return false;
+        }
+        std::string body(header.length, '\0');
+        if (!detail::recvAll(fd, &body[0], body.size(), never, error, timeout_ms)) {
+            return false;
+        }
+        try {
+            json parsed = json::parse(body);
+            hello.version = parsed.at("version").get<uint32_t>();
+            hello.channel = parsed.at("channel").get<std::string>();
+            hello.max_size = parsed.at("max_size").get<uint64_t>();
+            hello.sequence = parsed.at("sequence").get<uint64_t>();
+        } catch (const json::exception& e) {
+            error = std::string("Invalid bridge hello: ") + e.what();
+            return false;
+        }
+        if (hello.version != BRIDGE_VERSION) {
+            error = "Unsupported bridge version " + std::to_string(hello.version);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Constructor
+     * @param channel Local channel to publish into (must outlive the receiver)
+     * @param fd Connected stream socket, after readHello() (owned by the caller)
+     * @param hello HELLO frame received on fd
+     * @param sequence_offset Offset of the previous connection (getSequenceOffset()), so
+     *        a reconnect to a sender that did not restart resumes without duplicates
+     * @throws std::runtime_error if the local channel is smaller than the sender's
+     */
+    BridgeReceiver(SharedMemoryJSON& channel, int fd, const BridgeHello& hello, uint64_t sequence_offset = 0)
+        : channel_(channel)
+        , fd_(fd)
+        , sequence_offset_(sequence_offset)
+    {
+        if (hello.max_size > channel_.getMaxDataSize()) {
+            throw std::runtime_error("Local channel is smaller than the bridged channel " + hello.channel);
+        }
+        // The sender restarted below what was mirrored: its current data is
+        // new, so it lands just above the local sequence number
+        uint64_t local = channel_.getSequenceNumber();
+        if (hello.sequence + sequence_offset_ < local) {
+            sequence_offset_ = local - hello.sequence + 1;
+        }
+    }
+
+    ~BridgeReceiver() {
+        stop();
+    }
+
+    // Prevent copying
+    BridgeReceiver(const BridgeReceiver&) = delete;
+    BridgeReceiver& operator=(const BridgeReceiver&) = delete;
+
+    /**
+     * Start receiving on a background thread
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+        last_published_ = channel_.getSequenceNumber();
+        stopping_ = false;
+        running_ = true;
+        thread_ = std::thread([this]() { receiveLoop(); });
+    }
+
+    /**
+     * Stop the background thread
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+        thread_.join();
+        running_ = false;
+    }
+
+    /**
+     * Whether the connection is still open (false once the sender went away or sent garbage)
+     */
+    bool isConnected() const {
+        return connected_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Counters since construction (safe to call while running)
+     */
+    BridgeStats getStats() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return stats_;
+    }
+
+    /**
+     * Amount added to the sender's sequence numbers before publishing
+     * (non-zero once the sender restarted below the local sequence number)
+     */
+    uint64_t getSequenceOffset() const {
+        return sequence_offset_;
+    }
+
+    /**
+     * Last socket, protocol or publish error
+     */
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return last_error_;
+    }
+
+private:
+    SharedMemoryJSON& channel_;
+    int fd_;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> connected_{true};
+    bool running_ = false;
+    uint64_t sequence_offset_;
+    uint64_t last_published_ = 0;
+
+    std::string body_;
+    std::string raw_;
+    std::string payload_;                  // Payload of the last frame
+    json document_;                        // Parsed payload_, once a delta needed it
+    bool document_valid_ = false;
+
+    mutable std::mutex stats_mutex_;
+    BridgeStats stats_;
+    std::string last_error_;
+
+    void fail(const std::string& error) {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        last_error_ = error;
+        connected_ = false;
+    }
+
+    void receiveLoop() {
+        std::string error;
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            BridgeFrameHeader header;
+            if (!detail::recvAll(fd_, &header, sizeof(header), stopping_, error)) {
+                break;
+            }
+            if (header.magic != BRIDGE_MAGIC ||
+                (header.type != static_cast<uint8_t>(BridgeFrameType::Full) &&
+                 header.type != static_cast<uint8_t>(BridgeFrameType::Delta))) {
+                fail("Invalid bridge frame");
+                return;
+            }
+            if (header.length > channel_.getMaxDataSize() || header.raw_length > channel_.getMaxDataSize()) {
+                fail("Bridge frame exceeds the channel size");
+                return;
+            }
+            body_.resize(header.length);
+            if (!detail::recvAll(fd_, &body_[0], body_.size(), stopping_, error)) {
+                break;
+            }
+            if (!decode(header, error)) {
+                fail(error);
+                return;
+            }
+            publish(header, header.type == static_cast<uint8_t>(BridgeFrameType::Delta));
+        }
+        if (!stopping_.load(std::memory_order_relaxed)) {
+            fail(error);
+        }
+    }
+
+    // Rebuild the payload of a frame into payload_
+    bool decode(const BridgeFrameHeader& header, std::string& error) {
+        std::string* raw = &body_;
+        if (header.flags & BRIDGE_FLAG_COMPRESSED) {
+#ifdef SHM_ENABLE_ZLIB
+            if (!detail::zlibDecompress(body_, raw_, header.raw_length)) {
+                error = "Corrupt compressed bridge frame";
+                return false;
+            }
+            raw = &raw_;
+#else
+            error = "Compressed bridge frame, but built without SHM_ENABLE_ZLIB";
+            return false;
+#endif
+        }
+
+        if (header.type == static_cast<uint8_t>(BridgeFrameType::Full)) {
+            payload_.swap(*raw);
+            document_valid_ = false;
+            return true;
+        }
+
+        try {
+            if (!document_valid_) {
+                document_ = json::parse(payload_);
+            }
+            document_ = document_.patch(json::parse(*raw));
+            payload_ = document_.dump();
+            document_valid_ = true;
+        } catch (const json::exception& e) {
+            error = std::string("Cannot apply bridge delta: ") + e.what();
+            return false;
+        }
+        if (payload_.size() > channel_.getMaxDataSize()) {
+            error = "Bridge delta exceeds the channel size";
+            return false;
+        }
+        return true;
+    }
+
+    void publish(const BridgeFrameHeader& header, bool delta) {
+        uint64_t sequence = header.sequence + sequence_offset_;
+        bool skipped = sequence <= last_published_;
+        bool ok = skipped || channel_.republish(payload_, sequence, header.timestamp);
+        if (ok && !skipped) {
+            last_published_ = sequence;
+        }
+
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        stats_.frames++;
+        (delta ? stats_.delta_frames : stats_.full_frames)++;
+        stats_.compressed_frames += (header.flags & BRIDGE_FLAG_COMPRESSED) ? 1 : 0;
+        stats_.payload_bytes += payload_.size();
+        stats_.wire_bytes += sizeof(header) + header.length;
+        if (skipped) {
+            stats_.skipped++;
+        } else if (!ok) {
+            stats_.failed++;
+            last_error_ = channel_.getLastError();
+        } else {
+            stats_.last_sequence = sequence;
+        }
+    }
+};
+
+} // namespace shared_memory
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#include <cpuid.h>
+#include <x86intrin.h>
+#define SHM_BUSY_POLL_X86 1
+#endif
+
+namespace shared_memory {
+
+/**
+ * Pin the calling thread to a single CPU
+ * @return true on success (always false on platforms without affinity support)
+ */
+inline bool pinThreadToCpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+struct BusyPollOptions {
+    int cpu = -1;                   // Pin the polling thread to this CPU on first wait (-1 = don't pin)
+    bool use_umwait = true;         // Use UMONITOR/UMWAIT instead of PAUSE when the CPU has WAITPKG
+    uint32_t umwait_tsc_ticks = 20000; // Upper bound on a single UMWAIT sleep
+};
+
+struct SpinStats {
+    uint64_t waits = 0;             // Calls to waitForUpdate()
+    uint64_t updates = 0;           // Waits that observed a new sequence
+    uint64_t timeouts = 0;          // Waits that gave up
+    uint64_t polls = 0;             // Sequence loads performed while spinning
+    uint64_t umwaits = 0;           // UMWAIT instructions executed
+    uint64_t spin_ns = 0;           // Total time spent inside waitForUpdate()
+
+    /**
+     * Fraction of polls that found new data (1.0 means every poll was useful)
+     */
+    double efficiency() const {
+        return polls ? static_cast<double>(updates) / static_cast<double>(polls) : 0.0;
+    }
+};
+
+/**
+ * Low-latency reader that spins on the header sequence number instead of
+ * sleeping in the kernel.
+ *
+ * Intended for consumers on dedicated cores: it burns a full CPU while
+ * waiting but sees a new sequence within the cache-line transfer time.
+ * Each instance must be used from a single thread.
+ */
+class BusyPollReader {
+public:
+    BusyPollReader(SharedMemoryJSON& channel, BusyPollOptions options = BusyPollOptions())
+        : channel_(channel)
+        , options_(options)
+        , sequence_(&reinterpret_cast<SharedMemoryHeader*>(channel.mapped_ptr_)->sequence_number)
+        , umwait_(options.use_umwait && cpuHasWaitpkg())
+    {
+    }
+
+    /**
+     * Spin until the sequence number moves past last_seq
+     * @param last_seq Last sequence number seen
+     * @param timeout_us Give up after this many microseconds
+     * @return true if newer data is available, false on timeout
+     */
+    bool waitForUpdate(uint64_t last_seq, uint64_t timeout_us) {
+        if (!pinned_ && options_.cpu >= 0) {
+            pinned_ = pinThreadToCpu(options_.cpu);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::microseconds(timeout_us);
+        stats_.waits++;
+        touchHeartbeat(start);
+
+        bool updated = false;
+        for (uint64_t iteration = 1;; ++iteration) {
+            stats_.polls++;
+            if (sequence_->load(std::memory_order_acquire) > last_seq) {
+                updated = true;
+                break;
+            }
+            // Reading the clock costs more than a poll, so only check it periodically
+            if ((iteration & 63) == 0) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) {
+                    break;
+                }
+                touchHeartbeat(now);
+            }
+            relax(last_seq);
+        }
+
+        (updated ? stats_.updates : stats_.timeouts)++;
+        stats_.spin_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        return updated;
+    }
+
+    /**
+     * Spin for new data, then read it
+     * @param data Output parameter for JSON object
+     * @param sequence Output parameter for the sequence number of data
+     * @param last_seq Last sequence number seen
+     * @param timeout_us Give up after this many microseconds
+     * @return true if new data was read
+     */
+    bool read(json& data, uint64_t& sequence, uint64_t last_seq, uint64_t timeout_us) {
+        return waitForUpdate(last_seq, timeout_us) && channel_.read(data, sequence);
+    }
+
+    /**
+     * Spin statistics accumulated since construction or resetStats()
+     */
+    const SpinStats& getStats() const {
+        return stats_;
+    }
+
+    void resetStats() {
+        stats_ = SpinStats();
+    }
+
+    /**
+     * Whether UMONITOR/UMWAIT is used on this CPU
+     */
+    bool usesUmwait() const {
+        return umwait_;
+    }
+
+    /**
+     * Whether the polling thread was pinned to the configured CPU
+     */
+    bool isPinned() const {
+        return pinned_;
+    }
+
+private:
+    SharedMemoryJSON& channel_;
+    BusyPollOptions options_;
+    const std::atomic<uint64_t>* sequence_;
+    bool umwait_;
+    bool pinned_ = false;
+    std::chrono::steady_clock::time_point last_heartbeat_;
+    SpinStats stats_;
+
+    // A spinning reader is active, but never passes through the calls that
+    // refresh its heartbeat; keep it fresh for hasActiveReaders(max_idle_ms)
+    void touchHeartbeat(std::chrono::steady_clock::time_point now) {
+        if (now - last_heartbeat_ >= std::chrono::milliseconds(100)) {
+            last_heartbeat_ = now;
+            channel_.touchHeartbeat();
+        }
+    }
+
+    void relax(uint64_t last_seq) {
+#if defined(SHM_BUSY_POLL_X86)
+        if (umwait_) {
+            stats_.umwaits++;
+            umwaitOn(sequence_, last_seq, options_.umwait_tsc_ticks);
+            return;
+        }
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#else
+        (void)last_seq;
+#endif
+    }
+
+#if defined(SHM_BUSY_POLL_X86)
+    // Sleep in C0.1 until the sequence cache line is written or the TSC deadline passes
+    __attribute__((target("waitpkg")))
+    static void umwaitOn(const std::atomic<uint64_t>* sequence, uint64_t last_seq, uint32_t ticks) {
+        _umonitor(const_cast<std::atomic<uint64_t>*>(sequence));
+        if (sequence->load(std::memory_order_acquire) > last_seq) {
+            return; // Changed between the poll and arming the monitor
+        }
+        _umwait(1, __rdtsc() + ticks);
+    }
+
+    static bool cpuHasWaitpkg() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (ecx & (1u << 5)) != 0;
+    }
+#else
+    static bool cpuHasWaitpkg() {
+        return false;
+    }
+#endif
+};
+
+} // namespace shared_memory
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+namespace shared_memory {
+
+/**
+ * One channel's entry in a ChannelSet snapshot
+ */
+struct ChannelSnapshot {
+    bool valid = false;
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;     // Write time (microseconds since epoch)
+    json data;
+    std::string error;          // Why valid is false
+};
+
+/**
+ * Result of ChannelSet::snapshot()
+ */
+struct Snapshot {
+    std::vector<ChannelSnapshot> channels;  // Same order as the set
+    uint64_t capture_ns = 0;    // Time from the first copy to the last successful validation
+    unsigned retries = 0;       // Channel copies repeated because a write raced the capture
+};
+
+/**
+ * A set of channels that can be waited on together.
+ *
+ * waitAny() blocks until at least one member publishes a sequence newer than
+ * the last one it reported, so a single thread can follow many channels with
+ * latency independent of how many of them are quiet.
+ */
+class ChannelSet {
+public:
+    ChannelSet() = default;
+
+    ~ChannelSet() {
+#if defined(__linux__)
+        if (epoll_fd_ != -1) {
+            close(epoll_fd_);
+        }
+#endif
+    }
+
+    // Prevent copying
+    ChannelSet(const ChannelSet&) = delete;
+    ChannelSet& operator=(const ChannelSet&) = delete;
+
+    /**
+     * Add a channel to the set
+     * @param channel Channel to watch (must outlive the set)
+     * @param last_seq Sequence number already seen (0 to report the current data)
+     * @return Index of the channel within the set
+     */
+    size_t add(SharedMemoryJSON& channel, uint64_t last_seq = 0) {
+        members_.push_back({&channel, last_seq});
+        fallback_ready_ = false;
+        return members_.size() - 1;
+    }
+
+    /**
+     * Swap the channel at index for another one, e.g. a reopened instance after
+     * the original was replaced (see SharedMemoryJSON::isReplaced())
+     * @param index Index returned by add()
+     * @param channel Channel to watch instead (must outlive the set)
+     * @param last_seq Sequence number already seen (0 to report the current data)
+     */
+    void replace(size_t index, SharedMemoryJSON& channel, uint64_t last_seq = 0) {
+        members_.at(index) = {&channel, last_seq};
+        fallback_ready_ = false;
+    }
+
+    /**
+     * Number of channels in the set
+     */
+    size_t size() const {
+        return members_.size();
+    }
+
+    /**
+     * Get a member channel by index
+     */
+    SharedMemoryJSON& channel(size_t index) {
+        return *members_.at(index).channel;
+    }
+
+    /**
+     * Last sequence number reported for a member channel
+     */
+    uint64_t lastSequence(size_t index) const {
+        return members_.at(index).last_seq;
+    }
+
+    /**
+     * Wait until any member channel publishes new data
+     * @param timeout_ms Timeout in milliseconds
+     * @return Indices of channels whose sequence number moved since the last call
+     *         (empty on timeout; an empty set sleeps for the whole timeout)
+     *
+     * @note On Linux this uses futex_waitv() on every member's futex word. On
+     *       kernels without it (< 5.16) or with more than 128 members it falls
+     *       back to epoll over the members' notify fds.
+     */
+    std::vector<size_t> waitAny(uint64_t timeout_ms) {
+        auto deadline = detail::deadlineAfter(timeout_ms);
+        std::vector<size_t> changed;
+
+        if (members_.empty()) {
+            // Nothing can change; don't let callers that loop on waitAny() spin
+            std::this_thread::sleep_until(deadline);
+            last_error_ = "Timeout waiting for new data";
+            return changed;
+        }
+
+        while (true) {
+            collectChanged(changed);
+            if (!changed.empty()) {
+                return changed;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                last_error_ = "Timeout waiting for new data";
+                return changed;
+            }
+
+#if defined(__linux__)
+            if (!use_fallback_ && waitFutexes(deadline)) {
+                continue;
+            }
+            use_fallback_ = true;
+            if (!waitNotifyFds(deadline)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+#else
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+        }
+    }
+
+    /**
+     * Capture all member channels at (nearly) the same moment without taking any lock
+     * @param max_rounds Rounds of re-copying channels that were written during the capture
+     * @return Per-channel payloads, sequences and timestamps
+     *
+     * @note Seqlock counters of every channel are recorded first, then all payloads
+     *       are copied, then all counters are re-validated. Only channels written
+     *       in between are copied again. JSON parsing happens after the capture,
+     *       so the window covers memcpy only.
+     */
+    Snapshot snapshot(unsigned max_rounds = 100) {
+        Snapshot result;
+        result.channels.resize(members_.size());
+        std::vector<std::string> payloads(members_.size());
+        std::vector<uint64_t> counters(members_.size());
+        std::vector<size_t> pending(members_.size());
+        for (size_t i = 0; i < members_.size(); ++i) {
+            pending[i] = i;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned round = 0; round < max_rounds && !pending.empty(); ++round) {
+            std::vector<size_t> copying;
+            std::vector<size_t> retry;
+            for (size_t i : pending) {
+                SharedMemoryJSON& channel = *members_[i].channel;
+                if (!channel.seqlockBegin(counters[i])) {
+                    result.channels[i].error = channel.getLastError();
+                } else if (counters[i] & 1) {
+                    retry.push_back(i); // Write in progress
+                } else {
+                    copying.push_back(i);
+                }
+            }
+            for (size_t i : copying) {
+                ChannelSnapshot& entry = result.channels[i];
+                if (!members_[i].channel->seqlockCopy(payloads[i], entry.sequence, entry.timestamp)) {
+                    counters[i] = 1; // Torn size field, force a retry
+                }
+            }
+            for (size_t i : copying) {
+                if (members_[i].channel->seqlockValidate(counters[i])) {
+                    result.channels[i].valid = true;
+                } else {
+                    retry.push_back(i);
+                }
+            }
+            if (round > 0) {
+                result.retries += static_cast<unsigned>(pending.size());
+            }
+            pending.swap(retry);
+        }
+        result.capture_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+        for (size_t i : pending) {
+            result.channels[i].error = "Writer kept interfering with snapshot";
+        }
+        for (size_t i = 0; i < members_.size(); ++i) {
+            ChannelSnapshot& entry = result.channels[i];
+            if (!entry.valid) {
+                continue;
+            }
+            try {
+                entry.data = json::parse(payloads[i]);
+            } catch (const std::exception& e) {
+                entry.valid = false;
+                entry.error = e.what();
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Get last error message
+     */
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    struct Member {
+        SharedMemoryJSON* channel;
+        uint64_t last_seq;
+    };
+
+    std::vector<Member> members_;
+    std::string last_error_;
+    bool use_fallback_ = false;
+    bool fallback_ready_ = false;
+
+    static SharedMemoryHeader* headerOf(const Member& member) {
+        return reinterpret_cast<SharedMemoryHeader*>(member.channel->mapped_ptr_);
+    }
+
+    void collectChanged(std::vector<size_t>& changed) {
+        for (size_t i = 0; i < members_.size(); ++i) {
+            uint64_t seq = headerOf(members_[i])->sequence_number.load(std::memory_order_acquire);
+            if (seq > members_[i].last_seq) {
+                members_[i].last_seq = seq;
+                changed.push_back(i);
+            }
+        }
+    }
+
+    bool anyChanged() const {
+        for (const auto& member : members_) {
+            if (headerOf(member)->sequence_number.load() > member.last_seq) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#if defined(__linux__)
+    int epoll_fd_ = -1;
+
+    /**
+     * One futex_waitv() round over all members
+     * @return false if futex_waitv is unavailable and the fallback must be used
+     */
+    bool waitFutexes(std::chrono::steady_clock::time_point deadline) {
+#if defined(SYS_futex_waitv) && defined(FUTEX_WAITV_MAX)
+        if (members_.size() > FUTEX_WAITV_MAX) {
+            return false;
+        }
+
+        std::vector<futex_waitv> waiters(members_.size());
+        for (size_t i = 0; i < members_.size(); ++i) {
+            SharedMemoryHeader* header = headerOf(members_[i]);
+            header->waiter_count.fetch_add(1);
+            waiters[i].val = header->notify_word.load();
+            waiters[i].uaddr = reinterpret_cast<uintptr_t>(&header->notify_word);
+            waiters[i].flags = FUTEX_32;
+            waiters[i].__reserved = 0;
+        }
+
+        long result = 0;
+        int error = 0;
+        if (!anyChanged()) {
+            // futex_waitv takes an absolute CLOCK_MONOTONIC deadline, same clock as steady_clock on Linux
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+            timespec timeout;
+            timeout.tv_sec = static_cast<time_t>(ns / 1000000000);
+            timeout.tv_nsec = static_cast<long>(ns % 1000000000);
+            result = syscall(SYS_futex_waitv, waiters.data(), static_cast<unsigned>(waiters.size()),
+                             0, &timeout, CLOCK_MONOTONIC);
+            error = errno;
+        }
+
+        for (const auto& member : members_) {
+            headerOf(member)->waiter_count.fetch_sub(1);
+        }
+
+        return !(result == -1 && error == ENOSYS);
+#else
+        (void)deadline;
+        return false;
+#endif
+    }
+
+    /**
+     * Fallback: wait on the members' notify fds with epoll
+     * @return false if the notify fds could not be set up
+     */
+    bool waitNotifyFds(std::chrono::steady_clock::time_point deadline) {
+        if (!fallback_ready_) {
+            if (epoll_fd_ != -1) {
+                close(epoll_fd_);
+            }
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd_ == -1) {
+                last_error_ = "Failed to create epoll instance: " + std::string(strerror(errno));
+                return false;
+            }
+            for (auto& member : members_) {
+                int fd = member.channel->getNotifyFd();
+                if (fd == -1) {
+                    last_error_ = member.channel->getLastError();
+                    return false;
+                }
+                epoll_event event = {};
+                event.events = EPOLLIN;
+                event.data.ptr = member.channel;
+                epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+            }
+            fallback_ready_ = true;
+            // Writes that landed before registration are caught by collectChanged()
+            if (anyChanged()) {
+                return true;
+            }
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        epoll_event events[64];
+        int count = epoll_wait(epoll_fd_, events, 64, static_cast<int>(std::max<long long>(remaining, 0) + 1));
+        for (int i = 0; i < count; ++i) {
+            static_cast<SharedMemoryJSON*>(events[i].data.ptr)->consumeNotifications();
+        }
+        return true;
+    }
+#endif
+};
+
+} // namespace shared_memory
@@ -0,0 +1,418 @@
+#pragma once
+
+// Periodic checkpoints of a channel's payload to a file, and restore at
+// startup (POSIX only).
+//
+// A checkpoint file is a CheckpointHeader followed by the serialized JSON
+// payload, zero-padded to a multiple of CHECKPOINT_ALIGNMENT so it can be
+// written with O_DIRECT. Each checkpoint is written to <path>.tmp and renamed
+// over <path>, so the file always holds a complete checkpoint.
+
+#include "shared_memory_json.hpp"
+
+#ifdef _WIN32
+#error "shared_memory_checkpoint.hpp requires POSIX file I/O"
+#endif
+
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+
+namespace shared_memory {
+
+constexpr uint64_t CHECKPOINT_MAGIC = 0x3130504B434D4853ull; // "SHMCKP01"
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+constexpr size_t CHECKPOINT_ALIGNMENT = 4096;              // O_DIRECT buffer, offset and length alignment
+
+struct CheckpointHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t sequence;                     // Channel sequence of the payload
+    uint64_t timestamp;                    // Write time in the channel (microseconds since epoch)
+    uint64_t taken_at;                     // Time of the checkpoint (microseconds since epoch)
+    uint64_t data_size;                    // Payload bytes (without padding)
+    uint64_t checksum;                     // FNV-1a of the payload
+    uint64_t padding;
+};
+static_assert(sizeof(CheckpointHeader) == 64, "CheckpointHeader must stay 64 bytes");
+
+/**
+ * Contents of a checkpoint file (see readCheckpoint())
+ */
+struct Checkpoint {
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;
+    uint64_t taken_at = 0;
+    std::string payload;                   // Serialized JSON as published
+};
+
+struct CheckpointOptions {
+    uint64_t interval_ms = 1000;           // Time between checkpoints
+    bool direct_io = true;                 // Write with O_DIRECT, falling back to buffered writes
+    bool sync = true;                      // fdatasync before the rename (skip only for tmpfs/tests)
+};
+
+struct CheckpointStats {
+    uint64_t checkpoints = 0;              // Checkpoint files written
+    uint64_t unchanged = 0;                // Intervals skipped because the sequence had not moved
+    uint64_t failed = 0;                   // Snapshot or file errors
+    uint64_t bytes = 0;                    // Payload bytes written
+    uint64_t last_sequence = 0;            // Sequence of the last checkpoint
+    uint64_t last_duration_us = 0;         // Snapshot to rename of the last checkpoint
+    bool direct_io = false;                // Whether the last checkpoint bypassed the page cache
+};
+
+namespace detail {
+
+inline uint64_t checkpointChecksum(const char* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+inline bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+struct FreeDeleter {
+    void operator()(char* ptr) const { std::free(ptr); }
+};
+
+} // namespace detail
+
+/**
+ * Read and verify a checkpoint file
+ * @param path Checkpoint file written by ChannelCheckpointer
+ * @param checkpoint Output parameter for the checkpoint
+ * @param error Output parameter for the reason of a failure
+ * @return true if the file holds a complete, intact checkpoint
+ */
+inline bool readCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "Failed to open " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<uint64_t>(st.st_size) < sizeof(CheckpointHeader)) {
+        error = "Truncated checkpoint " + path;
+        ::close(fd);
+        return false;
+    }
+
+    // Map rather than read, so the payload is copied once, straight out of the page cache
+    size_t file_size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        error = "Failed to map " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    CheckpointHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    const char* payload = static_cast<const char*>(mapped) + sizeof(CheckpointHeader);
+    bool ok = false;
+    if (header.magic != CHECKPOINT_MAGIC) {
+        error = "Not a checkpoint file: " + path;
+    } else if (header.version != CHECKPOINT_VERSION) {
+        error = "Unsupported checkpoint version in " + path;
+    } else if (header.data_size > file_size - sizeof(CheckpointHeader)) {
+        error = "Truncated checkpoint " + path;
+    } else if (detail::checkpointChecksum(payload, header.data_size) != header.checksum) {
+        error = "Checksum mismatch in " + path;
+    } else {
+        checkpoint.sequence = header.sequence;
+        checkpoint.timestamp = header.timestamp;
+        checkpoint.taken_at = header.taken_at;
+        checkpoint.payload.assign(payload, header.data_size);
+        ok = true;
+    }
+    munmap(mapped, file_size);
+    return ok;
+}
+
+/**
+ * Publish the payload of a checkpoint file into a channel at its original
+ * sequence number and timestamp (call at startup, before the first write)
+ * @param channel Channel to restore; its sequence number must be below the checkpoint's
+ * @param path Checkpoint file written by ChannelCheckpointer
+ * @param error Output parameter for the reason of a failure
+ * @param sequence Optional output parameter for the restored sequence number
+ * @return true if the checkpoint was published
+ */
+inline bool restoreCheckpoint(SharedMemoryJSON& channel, const std::string& path, std::string& error,
+                              uint64_t* sequence = nullptr) {
+    Checkpoint checkpoint;
+    if (!readCheckpoint(path, checkpoint, error)) {
+        return false;
+    }
+    if (!channel.republish(checkpoint.payload, checkpoint.sequence, checkpoint.timestamp)) {
+        error = channel.getLastError();
+        return false;
+    }
+    if (sequence) {
+        *sequence = checkpoint.sequence;
+    }
+    return true;
+}
+
+/**
+ * Periodically saves a channel's payload to a checkpoint file.
+ *
+ * A background thread takes a lock-free snapshot with readSerialized(), whose
+ * sequence validation guarantees a consistent copy without blocking the
+ * writer, and writes it to disk. The write path of the channel never waits
+ * for the disk; a crash loses at most one interval of updates. Intervals in
+ * which the sequence number did not move are skipped.
+ */
+class ChannelCheckpointer {
+public:
+    /**
+     * Constructor
+     * @param channel Channel to checkpoint (must outlive the checkpointer and not be
+     *        used by other threads, e.g. a second instance opened with create=false)
+     * @param path Checkpoint file; <path>.tmp is used while writing
+     * @param options Interval and I/O mode
+     */
+    ChannelCheckpointer(SharedMemoryJSON& channel, const std::string& path,
+                        CheckpointOptions options = CheckpointOptions())
+        : channel_(channel)
+        , path_(path)
+        , options_(options)
+    {
+    }
+
+    ~ChannelCheckpointer() {
+        stop();
+    }
+
+    // Prevent copying
+    ChannelCheckpointer(const ChannelCheckpointer&) = delete;
+    ChannelCheckpointer& operator=(const ChannelCheckpointer&) = delete;
+
+    /**
+     * Start checkpointing every interval_ms on a background thread
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(wake_mutex_);
+            stopping_ = false;
+        }
+        running_ = true;
+        thread_ = std::thread([this]() { checkpointLoop(); });
+    }
+
+    /**
+     * Stop the background thread, taking a final checkpoint
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        running_ = false;
+    }
+
+    /**
+     * Take a checkpoint now (only while the background thread is stopped)
+     * @return true if a checkpoint was written or the sequence had not moved
+     */
+    bool checkpointNow() {
+        if (running_) {
+            setError("checkpointNow() called while the background thread is running");
+            return false;
+        }
+        return takeCheckpoint();
+    }
+
+    /**
+     * Counters since construction (safe to call while running)
+     */
+    CheckpointStats getStats() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return stats_;
+    }
+
+    /**
+     * Last snapshot or file error
+     */
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        return last_error_;
+    }
+
+private:
+    SharedMemoryJSON& channel_;
+    std::string path_;
+    CheckpointOptions options_;
+
+    std::thread thread_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    bool running_ = false;
+
+    uint64_t last_sequence_ = 0;
+    std::string payload_;
+    std::unique_ptr<char, detail::FreeDeleter> buffer_;   // Aligned for O_DIRECT
+    size_t buffer_size_ = 0;
+
+    mutable std::mutex stats_mutex_;
+    CheckpointStats stats_;
+    std::string last_error_;
+
+    void checkpointLoop() {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, std::chrono::milliseconds(options_.interval_ms), [this]() { return stopping_; });
+            lock.unlock();
+            takeCheckpoint();
+            lock.lock();
+        }
+    }
+
+    void setError(const std::string& error) {
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        stats_.failed++;
+        last_error_ = error;
+    }
+
+    bool takeCheckpoint() {
+        auto start = std::chrono::steady_clock::now();
+        if (channel_.peekSequenceNumber() == last_sequence_) {
+            if (last_sequence_ != 0) {
+                std::lock_guard<std::mutex> guard(stats_mutex_);
+                stats_.unchanged++;
+            }
+            return true; // Unchanged, or nothing published yet
+        }
+
+        uint64_t sequence, timestamp;
+        if (!channel_.readSerialized(payload_, sequence, timestamp)) {
+            setError("Snapshot failed: " + channel_.getLastError());
+            return false;
+        }
+
+        // Header and padded payload in one aligned buffer, so O_DIRECT can write it in one go
+        size_t used = sizeof(CheckpointHeader) + payload_.size();
+        size_t file_size = (used + CHECKPOINT_ALIGNMENT - 1) & ~(CHECKPOINT_ALIGNMENT - 1);
+        if (file_size > buffer_size_) {
+            void* memory = nullptr;
+            if (posix_memalign(&memory, CHECKPOINT_ALIGNMENT, file_size) != 0) {
+                setError("Failed to allocate checkpoint buffer");
+                return false;
+            }
+            buffer_.reset(static_cast<char*>(memory));
+            buffer_size_ = file_size;
+        }
+
+        CheckpointHeader header = {};
+        header.magic = CHECKPOINT_MAGIC;
+        header.version = CHECKPOINT_VERSION;
+        header.sequence = sequence;
+        header.timestamp = timestamp;
+        header.taken_at = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        header.data_size = payload_.size();
+        header.checksum = detail::checkpointChecksum(payload_.data(), payload_.size());
+        std::memcpy(buffer_.get(), &header, sizeof(header));
+        std::memcpy(buffer_.get() + sizeof(header), payload_.data(), payload_.size());
+        std::memset(buffer_.get() + used, 0, file_size - used);
+
+        bool direct = false;
+        std::string error;
+        if (!writeFile(file_size, direct, error)) {
+            setError(error);
+            return false;
+        }
+
+        last_sequence_ = sequence;
+        std::lock_guard<std::mutex> guard(stats_mutex_);
+        stats_.checkpoints++;
+        stats_.bytes += payload_.size();
+        stats_.last_sequence = sequence;
+        stats_.direct_io = direct;
+        stats_.last_duration_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        return true;
+    }
+
+    // Write the buffer to <path>.tmp and rename it over the checkpoint
+    bool writeFile(size_t size, bool& direct, std::string& error) {
+        std::string temp_path = path_ + ".tmp";
+        int fd = -1;
+#ifdef O_DIRECT
+        if (options_.direct_io) {
+            fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            if (fd != -1 && !detail::writeAll(fd, buffer_.get(), size)) {
+                // Some file systems (e.g. tmpfs) accept the flag but not the I/O
+                ::close(fd);
+                fd = -1;
+            }
+            direct = fd != -1;
+        }
+#endif
+        if (fd == -1) {
+            fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd == -1) {
+                error = "Failed to create " + temp_path + ": " + strerror(errno);
+                return false;
+            }
+            if (!detail::writeAll(fd, buffer_.get(), size)) {
+                error = "Failed to write " + temp_path + ": " + strerror(errno);
+                ::close(fd);
+                return false;
+            }
+        }
+
+        // O_DIRECT bypasses the page cache but not the file system metadata, so sync either way
+        if (options_.sync && fdatasync(fd) == -1) {
+            error = "Failed to sync " + temp_path + ": " + strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        ::close(fd);
+        if (::rename(temp_path.c_str(), path_.c_str()) == -1) {
+            error = "Failed to rename " + temp_path + ": " + strerror(errno);
+            return false;
+        }
+
+        // Make the rename itself durable
+        if (options_.sync) {
+            size_t slash = path_.rfind('/');
+            std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path_.substr(0, slash));
+            int dir_fd = ::open(directory.c_str(), O_RDONLY);
+            if (dir_fd != -1) {
+                fsync(dir_fd);
+                ::close(dir_fd);
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace shared_memory
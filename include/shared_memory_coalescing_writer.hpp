@@ -0,0 +1,208 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+
+#include <condition_variable>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * Latest-value publisher with per-channel rate limiting.
+ *
+ * update() may be called from any thread at any rate; it only stores the
+ * document. A background thread serializes and writes the most recent
+ * document of each channel at most max_rate_hz times per second, or
+ * immediately on flush(). Intermediate updates are dropped, so the
+ * serialization cost per channel is capped regardless of upstream rate.
+ */
+class CoalescingWriter {
+public:
+    /**
+     * Constructor
+     * @param max_rate_hz Maximum publish rate per channel (<= 0 publishes as soon as possible)
+     */
+    explicit CoalescingWriter(double max_rate_hz)
+        : min_interval_(max_rate_hz > 0
+              ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / max_rate_hz))
+              : std::chrono::steady_clock::duration::zero())
+    {
+        thread_ = std::thread([this]() { publishLoop(); });
+    }
+
+    /**
+     * Destructor - publishes pending updates, then stops the background thread
+     */
+    ~CoalescingWriter() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // Prevent copying
+    CoalescingWriter(const CoalescingWriter&) = delete;
+    CoalescingWriter& operator=(const CoalescingWriter&) = delete;
+
+    /**
+     * Add a channel to publish to
+     * @param channel Channel written by the background thread (must outlive the writer)
+     * @return Handle to pass to update()
+     */
+    size_t addChannel(SharedMemoryJSON& channel) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        slots_.push_back({&channel, std::nullopt, std::chrono::steady_clock::time_point(), 0, 0, 0});
+        return slots_.size() - 1;
+    }
+
+    /**
+     * Replace the pending document of a channel
+     * @param handle Value returned by addChannel()
+     * @param data Document to publish (pass with std::move to avoid a copy)
+     * @return false if handle is unknown
+     */
+    bool update(size_t handle, json data) {
+        json replaced;
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (handle >= slots_.size()) {
+                return false;
+            }
+            Slot& slot = slots_[handle];
+            was_empty = !slot.pending.has_value();
+            if (was_empty) {
+                slot.pending.emplace(std::move(data));
+            } else {
+                replaced = std::exchange(*slot.pending, std::move(data));
+                slot.coalesced++;
+            }
+        }
+        if (was_empty) {
+            cv_.notify_one();
+        }
+        // replaced is destroyed here, outside the lock
+        return true;
+    }
+
+    /**
+     * Publish every pending document now, ignoring the rate limit, and wait for completion
+     */
+    void flush() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        uint64_t target = ++flush_requested_;
+        cv_.notify_all();
+        flushed_cv_.wait(guard, [this, target]() { return flush_completed_ >= target; });
+    }
+
+    /**
+     * Number of documents written to a channel
+     */
+    uint64_t getPublishedCount(size_t handle) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return slots_.at(handle).published;
+    }
+
+    /**
+     * Number of updates to a channel that were replaced before being published
+     */
+    uint64_t getCoalescedCount(size_t handle) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return slots_.at(handle).coalesced;
+    }
+
+    /**
+     * Number of writes to a channel that failed (see the channel's getLastError())
+     */
+    uint64_t getFailedCount(size_t handle) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return slots_.at(handle).failed;
+    }
+
+private:
+    struct Slot {
+        SharedMemoryJSON* channel;
+        std::optional<json> pending;
+        std::chrono::steady_clock::time_point last_publish;
+        uint64_t published;
+        uint64_t coalesced;
+        uint64_t failed;
+    };
+
+    std::chrono::steady_clock::duration min_interval_;
+    std::vector<Slot> slots_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable flushed_cv_;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void publishLoop() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        while (true) {
+            bool force = stopping_ || flush_requested_ > flush_completed_;
+            uint64_t flush_target = flush_requested_;
+            auto now = std::chrono::steady_clock::now();
+            auto next_due = std::chrono::steady_clock::time_point::max();
+
+            for (size_t i = 0; i < slots_.size(); ++i) {
+                Slot& slot = slots_[i];
+                if (!slot.pending) {
+                    continue;
+                }
+                auto due = slot.last_publish + min_interval_;
+                if (!force && due > now) {
+                    next_due = std::min(next_due, due);
+                    continue;
+                }
+
+                json data = std::move(*slot.pending);
+                slot.pending.reset();
+                slot.last_publish = now;
+                SharedMemoryJSON* channel = slot.channel;
+
+                // Serialize and write without blocking producers
+                guard.unlock();
+                bool ok = channel->write(data);
+                guard.lock();
+
+                (ok ? slots_[i].published : slots_[i].failed)++;
+            }
+
+            if (force) {
+                flush_completed_ = flush_target;
+                flushed_cv_.notify_all();
+                if (stopping_) {
+                    return;
+                }
+                continue; // Catch updates that arrived while flushing
+            }
+
+            auto has_work = [this]() {
+                if (stopping_ || flush_requested_ > flush_completed_) {
+                    return true;
+                }
+                for (const Slot& slot : slots_) {
+                    if (slot.pending) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            if (next_due == std::chrono::steady_clock::time_point::max()) {
+                cv_.wait(guard, has_work);
+            } else {
+                cv_.wait_until(guard, next_due);
+            }
+        }
+    }
+};
+
+} // namespace shared_memory
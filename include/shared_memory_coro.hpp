@@ -0,0 +1,336 @@
+#pragma once
+
+// C++20 coroutine support for SharedMemoryJSON channels (Linux only).
+//
+// A single-threaded Reactor multiplexes the channels' notify fds with epoll and
+// resumes suspended coroutines when their channel publishes, so thousands of
+// tasks can wait on channels without a thread each.
+
+#include "shared_memory_json.hpp"
+
+#if !defined(__cpp_impl_coroutine) || !defined(__linux__)
+#error "shared_memory_coro.hpp requires C++20 coroutines and Linux"
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <optional>
+#include <vector>
+#include <unordered_map>
+#include <exception>
+#include <sys/epoll.h>
+
+namespace shared_memory {
+namespace coro {
+
+/**
+ * Result of awaiting a channel: the decoded payload and the sequence it was read at,
+ * or why the channel could not be watched or read
+ */
+struct ReadResult {
+    json data;
+    uint64_t sequence = 0;                 // On failure: of the unreadable payload if known, else 0
+    std::string error;                     // Empty on success
+
+    bool ok() const {
+        return error.empty();
+    }
+};
+
+/**
+ * Fire-and-forget coroutine type. Starts eagerly and frees itself on completion.
+ * An exception escaping the coroutine terminates the process; the awaitables
+ * below report failures in their results instead of throwing.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+class Reactor;
+
+namespace detail {
+
+struct Waiter {
+    SharedMemoryJSON* channel;
+    uint64_t last_seq;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::coroutine_handle<> handle;
+    bool timed_out = false;
+};
+
+} // namespace detail
+
+/**
+ * Event loop that resumes coroutines waiting on channels
+ */
+class Reactor {
+public:
+    Reactor() {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ == -1) {
+            throw std::runtime_error("Failed to create epoll instance: " + std::string(strerror(errno)));
+        }
+    }
+
+    ~Reactor() {
+        close(epoll_fd_);
+    }
+
+    // Prevent copying
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    /**
+     * Run until stop() is called or no coroutine is waiting
+     */
+    void run() {
+        stopped_ = false;
+        while (!stopped_ && !waiters_.empty()) {
+            runOnce(-1);
+        }
+    }
+
+    /**
+     * Wait for one batch of events and resume the coroutines they complete
+     * @param max_wait_ms Upper bound on the wait (-1 waits until the next event or deadline)
+     */
+    void runOnce(int max_wait_ms) {
+        int timeout_ms = computeTimeout(max_wait_ms);
+
+        epoll_event events[64];
+        int count = epoll_wait(epoll_fd_, events, 64, timeout_ms);
+        for (int i = 0; i < count; ++i) {
+            static_cast<SharedMemoryJSON*>(events[i].data.ptr)->consumeNotifications();
+        }
+
+        // Collect first: resumed coroutines usually register their next wait right away
+        std::vector<detail::Waiter*> ready;
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = waiters_.begin(); it != waiters_.end();) {
+            detail::Waiter* waiter = *it;
+            if (waiter->channel->waitForUpdate(waiter->last_seq, 0)) {
+                ready.push_back(waiter);
+                it = waiters_.erase(it);
+            } else if (waiter->deadline && now >= *waiter->deadline) {
+                waiter->timed_out = true;
+                ready.push_back(waiter);
+                it = waiters_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (detail::Waiter* waiter : ready) {
+            waiter->handle.resume();
+        }
+    }
+
+    /**
+     * Make run() return after the current batch
+     */
+    void stop() {
+        stopped_ = true;
+    }
+
+    /**
+     * Number of coroutines currently suspended on a channel
+     */
+    size_t pending() const {
+        return waiters_.size();
+    }
+
+    /**
+     * Register a suspended waiter
+     * @return false if the channel cannot be watched (the waiter must not suspend)
+     */
+    bool add(detail::Waiter* waiter) {
+        SharedMemoryJSON* channel = waiter->channel;
+        if (watched_.find(channel) == watched_.end()) {
+            int fd = channel->getNotifyFd();
+            if (fd == -1) {
+                return false;
+            }
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.ptr = channel;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+                return false;
+            }
+            watched_[channel] = fd;
+        }
+        waiters_.push_back(waiter);
+        return true;
+    }
+
+    /**
+     * Unregister a waiter that is not going to suspend after all
+     */
+    void remove(detail::Waiter* waiter) {
+        waiters_.erase(std::remove(waiters_.begin(), waiters_.end(), waiter), waiters_.end());
+    }
+
+    /**
+     * Stop watching a channel (call before destroying it)
+     */
+    void forget(SharedMemoryJSON& channel) {
+        auto it = watched_.find(&channel);
+        if (it != watched_.end()) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second, nullptr);
+            watched_.erase(it);
+        }
+    }
+
+private:
+    int epoll_fd_;
+    bool stopped_ = false;
+    std::vector<detail::Waiter*> waiters_;
+    std::unordered_map<SharedMemoryJSON*, int> watched_;
+
+    int computeTimeout(int max_wait_ms) const {
+        int timeout_ms = max_wait_ms;
+        auto now = std::chrono::steady_clock::now();
+        for (const detail::Waiter* waiter : waiters_) {
+            if (!waiter->deadline) {
+                continue;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(*waiter->deadline - now).count();
+            int wait = static_cast<int>(std::max<long long>(remaining + 1, 0));
+            if (timeout_ms < 0 || wait < timeout_ms) {
+                timeout_ms = wait;
+            }
+        }
+        return timeout_ms;
+    }
+};
+
+namespace detail {
+
+// Shared suspend logic for the plain and timeout awaitables
+class NextAwaitableBase {
+public:
+    NextAwaitableBase(Reactor& reactor, SharedMemoryJSON& channel, uint64_t last_seq,
+                      std::optional<std::chrono::steady_clock::time_point> deadline)
+        : reactor_(reactor)
+    {
+        waiter_.channel = &channel;
+        waiter_.last_seq = last_seq;
+        waiter_.deadline = deadline;
+    }
+
+    bool await_ready() {
+        return waiter_.channel->waitForUpdate(waiter_.last_seq, 0);
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        waiter_.handle = handle;
+        if (!reactor_.add(&waiter_)) {
+            // Resume at once; await_resume() reports the error instead of throwing into a Task
+            watch_error_ = "Failed to watch channel: " + waiter_.channel->getLastError();
+            return false;
+        }
+        // The notify fd is armed now; recheck so a write that raced registration isn't missed
+        if (waiter_.channel->waitForUpdate(waiter_.last_seq, 0)) {
+            reactor_.remove(&waiter_);
+            return false;
+        }
+        return true;
+    }
+
+protected:
+    Reactor& reactor_;
+    Waiter waiter_;
+    std::string watch_error_;
+
+    ReadResult readResult() {
+        ReadResult result;
+        if (!watch_error_.empty()) {
+            result.error = watch_error_;
+        } else if (!waiter_.channel->read(result.data, result.sequence)) {
+            result.error = "Failed to read channel: " + waiter_.channel->getLastError();
+        }
+        return result;
+    }
+};
+
+} // namespace detail
+
+/**
+ * Awaitable returned by AsyncChannel::next(last_seq); check ReadResult::ok()
+ */
+class NextAwaitable : public detail::NextAwaitableBase {
+public:
+    using NextAwaitableBase::NextAwaitableBase;
+
+    ReadResult await_resume() {
+        return readResult();
+    }
+};
+
+/**
+ * Awaitable returned by AsyncChannel::next(last_seq, timeout); yields std::nullopt
+ * on timeout and a ReadResult with an error if the read failed
+ */
+class NextForAwaitable : public detail::NextAwaitableBase {
+public:
+    using NextAwaitableBase::NextAwaitableBase;
+
+    std::optional<ReadResult> await_resume() {
+        if (waiter_.timed_out) {
+            return std::nullopt;
+        }
+        return readResult();
+    }
+};
+
+/**
+ * Coroutine view of a channel bound to a reactor
+ */
+class AsyncChannel {
+public:
+    AsyncChannel(Reactor& reactor, SharedMemoryJSON& channel)
+        : reactor_(reactor)
+        , channel_(channel)
+    {
+    }
+
+    ~AsyncChannel() {
+        reactor_.forget(channel_);
+    }
+
+    // Prevent copying
+    AsyncChannel(const AsyncChannel&) = delete;
+    AsyncChannel& operator=(const AsyncChannel&) = delete;
+
+    /**
+     * Wait for a sequence newer than last_seq:
+     * `auto result = co_await ch.next(last_seq); if (result.ok()) { ... }`
+     * (a failed read resumes with result.error set)
+     */
+    NextAwaitable next(uint64_t last_seq) {
+        return NextAwaitable(reactor_, channel_, last_seq, std::nullopt);
+    }
+
+    /**
+     * Like next(), but resumes with std::nullopt if nothing arrives within timeout
+     */
+    NextForAwaitable next(uint64_t last_seq, std::chrono::milliseconds timeout) {
+        return NextForAwaitable(reactor_, channel_, last_seq, std::chrono::steady_clock::now() + timeout);
+    }
+
+    SharedMemoryJSON& channel() {
+        return channel_;
+    }
+
+private:
+    Reactor& reactor_;
+    SharedMemoryJSON& channel_;
+};
+
+} // namespace coro
+} // namespace shared_memory
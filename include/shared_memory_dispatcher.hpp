@@ -0,0 +1,196 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+#include "shared_memory_channel_set.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * Subscriber dispatcher with a worker pool.
+ *
+ * A watcher thread waits on all subscribed channels with a ChannelSet and hands
+ * changed channels to N worker threads, which read, decode and invoke the
+ * channel's callback. Each channel is pinned to one worker, so callbacks for a
+ * channel run in order and never concurrently, while different channels are
+ * decoded in parallel. Updates that arrive while a channel is still queued are
+ * coalesced: the worker always reads the latest data.
+ *
+ * Subscribed channels must not be used by other threads while the dispatcher runs.
+ */
+class Dispatcher {
+public:
+    using Callback = std::function<void(const json& data, uint64_t sequence)>;
+
+    /**
+     * Constructor
+     * @param worker_count Number of worker threads (at least 1)
+     */
+    explicit Dispatcher(size_t worker_count)
+        : workers_(worker_count == 0 ? 1 : worker_count)
+    {
+    }
+
+    ~Dispatcher() {
+        stop();
+    }
+
+    // Prevent copying
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+
+    /**
+     * Register a callback for a channel (call before start())
+     * @param channel Channel to watch (must outlive the dispatcher)
+     * @param callback Invoked on a worker thread for each new sequence observed
+     * @param last_seq Sequence number already seen (0 to deliver the current data)
+     */
+    void subscribe(SharedMemoryJSON& channel, Callback callback, uint64_t last_seq = 0) {
+        if (running_) {
+            throw std::runtime_error("Cannot subscribe while the dispatcher is running");
+        }
+        size_t index = channels_.add(channel, last_seq);
+        auto subscription = std::make_unique<Subscription>();
+        subscription->callback = std::move(callback);
+        subscription->worker = index % workers_.size();
+        subscription->last_delivered = last_seq;
+        subscriptions_.push_back(std::move(subscription));
+    }
+
+    /**
+     * Start the watcher and worker threads
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+        running_ = true;
+        for (auto& worker : workers_) {
+            worker.stopping = false;
+            worker.thread = std::thread([this, &worker]() { workerLoop(worker); });
+        }
+        watcher_ = std::thread([this]() { watchLoop(); });
+    }
+
+    /**
+     * Stop all threads; queued updates that were not yet delivered are dropped
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        watcher_.join();
+        for (auto& worker : workers_) {
+            {
+                std::lock_guard<std::mutex> guard(worker.mutex);
+                worker.stopping = true;
+            }
+            worker.cv.notify_one();
+            worker.thread.join();
+            worker.queue.clear();
+        }
+        for (auto& subscription : subscriptions_) {
+            subscription->queued = false;
+        }
+    }
+
+    /**
+     * Total number of callbacks invoked
+     */
+    uint64_t getDeliveredCount() const {
+        return delivered_.load();
+    }
+
+    /**
+     * Number of reads that failed or callbacks that threw
+     */
+    uint64_t getErrorCount() const {
+        return errors_.load();
+    }
+
+private:
+    struct Subscription {
+        Callback callback;
+        size_t worker;
+        uint64_t last_delivered;
+        std::atomic<bool> queued{false};
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<size_t> queue;
+        bool stopping = false;
+    };
+
+    ChannelSet channels_;
+    std::vector<std::unique_ptr<Subscription>> subscriptions_;
+    std::vector<Worker> workers_;
+    std::thread watcher_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> errors_{0};
+
+    void watchLoop() {
+        while (running_) {
+            for (size_t index : channels_.waitAny(100)) {
+                Subscription& subscription = *subscriptions_[index];
+                if (subscription.queued.exchange(true)) {
+                    continue; // Worker hasn't picked up the previous update yet
+                }
+                Worker& worker = workers_[subscription.worker];
+                {
+                    std::lock_guard<std::mutex> guard(worker.mutex);
+                    worker.queue.push_back(index);
+                }
+                worker.cv.notify_one();
+            }
+        }
+    }
+
+    void workerLoop(Worker& worker) {
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> guard(worker.mutex);
+                worker.cv.wait(guard, [&worker]() { return worker.stopping || !worker.queue.empty(); });
+                if (worker.stopping) {
+                    return;
+                }
+                index = worker.queue.front();
+                worker.queue.pop_front();
+            }
+
+            Subscription& subscription = *subscriptions_[index];
+            // Clear before reading so an update landing during the read is queued again
+            subscription.queued = false;
+
+            json data;
+            uint64_t sequence = 0;
+            if (!channels_.channel(index).read(data, sequence)) {
+                errors_++;
+                continue;
+            }
+            if (sequence <= subscription.last_delivered) {
+                continue; // Already delivered by an earlier, coalesced read
+            }
+            subscription.last_delivered = sequence;
+
+            try {
+                subscription.callback(data, sequence);
+                delivered_++;
+            } catch (const std::exception&) {
+                errors_++;
+            }
+        }
+    }
+};
+
+} // namespace shared_memory
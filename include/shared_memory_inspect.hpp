@@ -0,0 +1,212 @@
+#pragma once
+
+// Read-only introspection of SharedMemoryJSON channels (POSIX only).
+//
+// Channels are mapped PROT_READ and only the header is examined; the channel
+// lock is never taken, so inspecting a hot production channel cannot stall
+// its writers or readers.
+
+#include "shared_memory_json.hpp"
+
+#ifdef _WIN32
+#error "shared_memory_inspect.hpp requires POSIX shared memory"
+#endif
+
+#include <algorithm>
+#include <vector>
+#include <dirent.h>
+
+namespace shared_memory {
+
+/**
+ * Header contents of one channel at the time it was inspected
+ */
+struct ChannelInfo {
+    std::string name;
+    uint64_t region_bytes = 0;        // Size of the mapping (header + data area)
+    uint64_t max_data_size = 0;       // Capacity of the data area
+    uint32_t version = 0;
+    bool compatible = false;          // Written by this PROTOCOL_VERSION; fields below are only valid if true
+    uint64_t data_size = 0;
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;           // Last write (microseconds since epoch)
+    uint64_t age_us = 0;              // Time since the last write
+    bool write_in_progress = false;   // Seqlock counter was odd
+    size_t readers = 0;               // Registered reader processes that are still alive
+    size_t notify_subscribers = 0;
+    uint32_t waiters = 0;             // Processes blocked in waitForUpdate()/waitAny()
+    ChannelStats stats;
+    LockProfile lock_profile;
+};
+
+namespace detail {
+
+class ReadOnlyMapping {
+public:
+    // Maps the shared memory object "/<name>", or the file at path if one is given
+    explicit ReadOnlyMapping(const std::string& name, const std::string& path = "") {
+        int fd = path.empty() ? shm_open(("/" + name).c_str(), O_RDONLY, 0) : open(path.c_str(), O_RDONLY | O_NONBLOCK);
+        if (fd == -1) {
+            error_ = (path.empty() ? "Failed to open shared memory: " : "Failed to open " + path + ": ") +
+                     std::string(strerror(errno));
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == -1) {
+            error_ = "Failed to stat shared memory: " + std::string(strerror(errno));
+            close(fd);
+            return;
+        }
+        if (!path.empty() && !S_ISREG(st.st_mode)) {
+            error_ = "Not a regular file";
+            close(fd);
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ >= sizeof(uint64_t)) {
+            ptr_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr_ == MAP_FAILED) {
+                ptr_ = nullptr;
+                error_ = "Failed to map shared memory: " + std::string(strerror(errno));
+            }
+        } else {
+            error_ = "Region too small to be a channel";
+        }
+        close(fd);
+    }
+
+    ~ReadOnlyMapping() {
+        if (ptr_) {
+            munmap(ptr_, size_);
+        }
+    }
+
+    ReadOnlyMapping(const ReadOnlyMapping&) = delete;
+    ReadOnlyMapping& operator=(const ReadOnlyMapping&) = delete;
+
+    const void* data() const { return ptr_; }
+    size_t size() const { return size_; }
+    const std::string& error() const { return error_; }
+
+private:
+    void* ptr_ = nullptr;
+    size_t size_ = 0;
+    std::string error_;
+};
+
+inline bool inspectMapping(const ReadOnlyMapping& mapping, const std::string& name, ChannelInfo& info,
+                           std::string& error) {
+    if (!mapping.data()) {
+        error = mapping.error();
+        return false;
+    }
+
+    // magic_number and version lead every header version, so they are safe to read first
+    const auto* prefix = static_cast<const std::atomic<uint32_t>*>(mapping.data());
+    if (prefix[0].load(std::memory_order_relaxed) != MAGIC_NUMBER) {
+        error = "Invalid magic number - not an initialized channel";
+        return false;
+    }
+
+    info = ChannelInfo();
+    info.name = name;
+    info.region_bytes = mapping.size();
+    info.version = prefix[1].load(std::memory_order_relaxed);
+    info.compatible = info.version == PROTOCOL_VERSION && mapping.size() >= HEADER_SIZE;
+    if (!info.compatible) {
+        return true; // Report the channel, but its layout is unknown
+    }
+
+    const auto* header = static_cast<const SharedMemoryHeader*>(mapping.data());
+    info.max_data_size = mapping.size() - HEADER_SIZE;
+    info.data_size = header->data_size.load(std::memory_order_relaxed);
+    info.sequence = header->sequence_number.load(std::memory_order_relaxed);
+    info.timestamp = header->timestamp.load(std::memory_order_relaxed);
+    info.write_in_progress = (header->write_counter.load(std::memory_order_relaxed) & 1) != 0;
+    info.waiters = header->waiter_count.load(std::memory_order_relaxed);
+
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    info.age_us = now > info.timestamp ? now - info.timestamp : 0;
+
+    for (const auto& slot : header->notify_slots) {
+        if (slot.load(std::memory_order_relaxed) != 0) {
+            info.notify_subscribers++;
+        }
+    }
+    for (const auto& slot : header->readers) {
+        uint32_t pid = slot.pid.load(std::memory_order_relaxed);
+        if (pid != 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM)) {
+            info.readers++;
+        }
+    }
+
+    info.stats = detail::loadStats(header->stats);
+    info.lock_profile = detail::loadLockProfile(header->lock_profile);
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * Inspect one channel without taking its lock
+ * @param name Channel name as passed to SharedMemoryJSON
+ * @param info Output parameter for the header contents
+ * @param error Output parameter for the reason on failure
+ * @param directory Directory holding the region as a file named after the channel,
+ *        e.g. a tmpfs or backing file directory (empty = POSIX shared memory)
+ * @return false if the region cannot be opened or has no valid MAGIC_NUMBER
+ *
+ * @note The magic number is written by the first write(), so channels that were
+ *       created but never written are not recognized.
+ */
+inline bool inspectChannel(const std::string& name, ChannelInfo& info, std::string& error,
+                           const std::string& directory = "") {
+    detail::ReadOnlyMapping mapping(name, directory.empty() ? "" : directory + "/" + name);
+    return detail::inspectMapping(mapping, name, info, error);
+}
+
+/**
+ * Inspect the channel stored in a file without taking its lock
+ * @param path Backing file (ChannelOptions::backing_path) or any file holding a region
+ * @param info Output parameter for the header contents; name is the file name
+ * @param error Output parameter for the reason on failure
+ * @return false if the file cannot be opened or has no valid MAGIC_NUMBER
+ */
+inline bool inspectChannelFile(const std::string& path, ChannelInfo& info, std::string& error) {
+    detail::ReadOnlyMapping mapping("", path);
+    size_t slash = path.find_last_of('/');
+    return detail::inspectMapping(mapping, slash == std::string::npos ? path : path.substr(slash + 1), info, error);
+}
+
+/**
+ * Find and inspect every channel in a directory
+ * @param directory Where POSIX shared memory objects live (Linux: /dev/shm), or
+ *        any directory of channel files such as backing files
+ * @return Channels with a valid MAGIC_NUMBER, sorted by name
+ */
+inline std::vector<ChannelInfo> listChannels(const std::string& directory = "/dev/shm") {
+    std::vector<ChannelInfo> channels;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return channels;
+    }
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        // Skip dot entries and the named semaphores glibc keeps next to the regions
+        if (name.empty() || name[0] == '.' || name.compare(0, 4, "sem.") == 0) {
+            continue;
+        }
+        ChannelInfo info;
+        std::string error;
+        if (inspectChannel(name, info, error, directory)) {
+            channels.push_back(std::move(info));
+        }
+    }
+    closedir(dir);
+    std::sort(channels.begin(), channels.end(),
+              [](const ChannelInfo& a, const ChannelInfo& b) { return a.name < b.name; });
+    return channels;
+}
+
+} // namespace shared_memory
@@ -6,6 +6,8 @@
 #include <mutex>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <array>
 #include <nlohmann/json.hpp>
 
 #ifdef _WIN32
@@ -16,26 +18,380 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <semaphore.h>
+#include <signal.h>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#endif
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstddef>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// USDT tracepoints (provider "shm_json") for bpftrace/perf/SystemTap. Define
+// SHM_ENABLE_USDT to compile them in; each probe is then a single NOP until a
+// tracer attaches. Without it the macros expand to nothing.
+#if defined(SHM_ENABLE_USDT)
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SHM_USDT_AVAILABLE 1
+#endif
+#endif
+#if !defined(SHM_USDT_AVAILABLE)
+#error "SHM_ENABLE_USDT requires <sys/sdt.h> (systemtap-sdt-dev / systemtap-sdt-devel)"
+#endif
+#define SHM_PROBE1(name, a1) STAP_PROBE1(shm_json, name, a1)
+#define SHM_PROBE2(name, a1, a2) STAP_PROBE2(shm_json, name, a1, a2)
+#define SHM_PROBE3(name, a1, a2, a3) STAP_PROBE3(shm_json, name, a1, a2, a3)
+#define SHM_PROBE4(name, a1, a2, a3, a4) STAP_PROBE4(shm_json, name, a1, a2, a3, a4)
+#else
+// Arguments are only named inside sizeof, so they are never evaluated
+#define SHM_PROBE1(name, a1) do { (void)sizeof(a1); } while (0)
+#define SHM_PROBE2(name, a1, a2) do { (void)sizeof(a1); (void)sizeof(a2); } while (0)
+#define SHM_PROBE3(name, a1, a2, a3) do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (0)
+#define SHM_PROBE4(name, a1, a2, a3, a4) do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); (void)sizeof(a4); } while (0)
+#endif
+
+// Allocation tracking: define SHM_TRACK_ALLOCATIONS before including this header
+// and expand SHM_DEFINE_ALLOCATION_HOOKS() at file scope in exactly one
+// translation unit. The hooks replace the global operator new/delete with
+// malloc/free plus per-thread counters, which write()/read() sample to report
+// their own allocations (see SharedMemoryJSON::getAllocationStats()).
+#if defined(SHM_TRACK_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+
+namespace shared_memory {
+namespace detail {
+struct AllocationCounter {
+    uint64_t count;
+    uint64_t bytes;
+};
+inline thread_local AllocationCounter thread_allocations = {0, 0};
+} // namespace detail
+} // namespace shared_memory
+
+// GCC flags free() on memory from the replaced operator new once both are inlined
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#define SHM_ALLOCATION_HOOKS_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmismatched-new-delete\"")
+#define SHM_ALLOCATION_HOOKS_END _Pragma("GCC diagnostic pop")
+#else
+#define SHM_ALLOCATION_HOOKS_BEGIN
+#define SHM_ALLOCATION_HOOKS_END
+#endif
+
+#define SHM_DEFINE_ALLOCATION_HOOKS()                                                              \
+    SHM_ALLOCATION_HOOKS_BEGIN                                                                     \
+    void* operator new(std::size_t size) {                                                         \
+        ::shared_memory::detail::thread_allocations.count++;                                       \
+        ::shared_memory::detail::thread_allocations.bytes += size;                                 \
+        if (void* ptr = std::malloc(size ? size : 1)) {                                            \
+            return ptr;                                                                            \
+        }                                                                                          \
+        throw std::bad_alloc();                                                                    \
+    }                                                                                              \
+    void* operator new[](std::size_t size) { return operator new(size); }                         \
+    void operator delete(void* ptr) noexcept { std::free(ptr); }                                   \
+    void operator delete[](void* ptr) noexcept { std::free(ptr); }                                 \
+    void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }                      \
+    void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }                    \
+    SHM_ALLOCATION_HOOKS_END
 #endif
 
 namespace shared_memory {
 
 using json = nlohmann::json;
 
+constexpr size_t MAX_NOTIFY_SUBSCRIBERS = 32;
+constexpr size_t MAX_READERS = 64;
+constexpr size_t LOCK_HISTOGRAM_BUCKETS = 32; // Power-of-two nanosecond buckets, last one open-ended
+
+// Operation that took the channel lock (index into the lock profile)
+enum class LockOp : uint32_t {
+    Write = 0,  // write()
+    Read = 1,   // read()
+    Query = 2   // getSequenceNumber()
+};
+constexpr size_t LOCK_OP_COUNT = 3;
+
+// Registration of one attached reader (pid 0 = free)
+struct ReaderSlot {
+    std::atomic<uint32_t> pid;
+    uint32_t reserved;
+    std::atomic<uint64_t> heartbeat;    // Last read or wait (microseconds since epoch)
+};
+
+// Live channel counters, updated with relaxed atomics by every process using the channel.
+// Writer-, reader- and lock-side counters sit on separate cache lines.
+struct ChannelStatsBlock {
+    alignas(64) std::atomic<uint64_t> writes;
+    std::atomic<uint64_t> bytes_written;
+    alignas(64) std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> failed_reads;
+    alignas(64) std::atomic<uint64_t> lock_acquisitions;
+    std::atomic<uint64_t> contended_acquisitions; // Acquisitions that had to block
+    std::atomic<uint64_t> lock_wait_ns;           // Total time spent blocked in lock()
+};
+
+// Wait/hold profile of one lock operation type, filled while profiling is enabled
+struct alignas(64) LockOpProfileBlock {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total_wait_ns;
+    std::atomic<uint64_t> total_hold_ns;
+    std::atomic<uint64_t> max_wait_ns;
+    std::atomic<uint64_t> max_hold_ns;
+    std::atomic<uint32_t> max_wait_pid;   // Process that waited longest
+    std::atomic<uint32_t> max_hold_pid;   // Process that held the lock longest
+    std::atomic<uint64_t> wait_histogram[LOCK_HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> hold_histogram[LOCK_HISTOGRAM_BUCKETS];
+};
+
+struct LockProfileBlock {
+    alignas(64) std::atomic<uint32_t> enabled;    // Set by enableLockProfiling(), honoured by every process
+    LockOpProfileBlock ops[LOCK_OP_COUNT];
+};
+
 // Shared memory region structure
 struct SharedMemoryHeader {
-    uint32_t magic_number;      // Validation magic number
-    uint32_t version;           // Protocol version
-    uint64_t data_size;         // Size of JSON data
-    uint64_t sequence_number;   // Incremented on each write (wraps after ~584 years at 1B writes/sec)
-    uint64_t timestamp;         // Last write timestamp (microseconds since epoch)
-    char padding[32];           // Reserved for future use
+    std::atomic<uint32_t> magic_number;    // Validation magic number
+    std::atomic<uint32_t> version;         // Protocol version
+    std::atomic<uint64_t> data_size;       // Size of JSON data
+    std::atomic<uint64_t> sequence_number; // Incremented on each write (wraps after ~584 years at 1B writes/sec)
+    std::atomic<uint64_t> timestamp;       // Last write timestamp (microseconds since epoch)
+    std::atomic<uint32_t> notify_word;     // Futex word bumped after each write
+    std::atomic<uint32_t> waiter_count;    // Processes blocked on notify_word (writers skip the wake when 0)
+    std::atomic<uint64_t> write_counter;   // Seqlock: odd while a write is in progress
+    std::atomic<uint32_t> lock_owner;      // Process holding the channel lock, 0 = none (see releaseAbandonedLock())
+    char padding[12];           // Reserved for future use
+    std::atomic<uint64_t> notify_slots[MAX_NOTIFY_SUBSCRIBERS]; // Notify fd subscribers (pid << 32 | token), 0 = free
+    ReaderSlot readers[MAX_READERS];    // Readers opened with create=false
+    ChannelStatsBlock stats;            // See SharedMemoryJSON::getStats()
+    LockProfileBlock lock_profile;      // See SharedMemoryJSON::getLockProfile()
 };
 
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Shared header atomics must be lock-free to work across processes");
+
 constexpr uint32_t MAGIC_NUMBER = 0x534D4A53; // "SMJS" - Shared Memory JSON
-constexpr uint32_t PROTOCOL_VERSION = 1;
+constexpr uint32_t PROTOCOL_VERSION = 7;
+
+/**
+ * Snapshot of a channel's counters (see SharedMemoryJSON::getStats())
+ */
+struct ChannelStats {
+    uint64_t writes = 0;                 // Successful writes
+    uint64_t bytes_written = 0;          // Serialized bytes published
+    uint64_t reads = 0;                  // Successful read()/readSerialized() calls
+    uint64_t failed_reads = 0;           // read()/readSerialized() calls that returned false
+    uint64_t lock_acquisitions = 0;      // Times any process took the channel lock
+    uint64_t contended_acquisitions = 0; // Acquisitions that found the lock held
+    uint64_t lock_wait_ns = 0;           // Total time blocked waiting for the lock
+};
+
+/**
+ * Lock wait and hold times of one operation type (see SharedMemoryJSON::getLockProfile())
+ *
+ * Histogram bucket i counts durations in [2^i, 2^(i+1)) nanoseconds; bucket 0
+ * also holds 0 and the last bucket everything above 2^31 ns.
+ */
+struct LockOpProfile {
+    uint64_t count = 0;
+    uint64_t total_wait_ns = 0;
+    uint64_t total_hold_ns = 0;
+    uint64_t max_wait_ns = 0;
+    uint64_t max_hold_ns = 0;
+    uint32_t max_wait_pid = 0;
+    uint32_t max_hold_pid = 0;
+    std::array<uint64_t, LOCK_HISTOGRAM_BUCKETS> wait_histogram{};
+    std::array<uint64_t, LOCK_HISTOGRAM_BUCKETS> hold_histogram{};
+
+    /**
+     * Upper bound of the bucket containing the given percentile (0-100) of wait times
+     */
+    uint64_t waitPercentile(double p) const {
+        return percentile(wait_histogram, p);
+    }
+
+    /**
+     * Upper bound of the bucket containing the given percentile (0-100) of hold times
+     */
+    uint64_t holdPercentile(double p) const {
+        return percentile(hold_histogram, p);
+    }
+
+private:
+    static uint64_t percentile(const std::array<uint64_t, LOCK_HISTOGRAM_BUCKETS>& histogram, double p) {
+        uint64_t total = 0;
+        for (uint64_t bucket : histogram) {
+            total += bucket;
+        }
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+        rank = rank == 0 ? 1 : (rank > total ? total : rank);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < LOCK_HISTOGRAM_BUCKETS; ++i) {
+            seen += histogram[i];
+            if (seen >= rank) {
+                return (uint64_t(2) << i) - 1;
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * Heap allocations made by this instance's write()/read() calls
+ * (see SharedMemoryJSON::getAllocationStats())
+ *
+ * Only allocations on the calling thread during the call are counted, so
+ * read() includes the parsed json but readSerialized() only the copied text.
+ */
+struct AllocationStats {
+    uint64_t writes = 0;             // write() calls measured
+    uint64_t write_allocations = 0;
+    uint64_t write_bytes = 0;
+    uint64_t reads = 0;              // read()/readSerialized() calls measured
+    uint64_t read_allocations = 0;
+    uint64_t read_bytes = 0;
+
+    double allocationsPerWrite() const { return perCall(write_allocations, writes); }
+    double bytesPerWrite() const { return perCall(write_bytes, writes); }
+    double allocationsPerRead() const { return perCall(read_allocations, reads); }
+    double bytesPerRead() const { return perCall(read_bytes, reads); }
+
+private:
+    static double perCall(uint64_t total, uint64_t calls) {
+        return calls ? static_cast<double>(total) / static_cast<double>(calls) : 0.0;
+    }
+};
+
+#if defined(SHM_TRACK_ALLOCATIONS)
+constexpr bool ALLOCATION_TRACKING = true;
+#else
+constexpr bool ALLOCATION_TRACKING = false;
+#endif
+
+/**
+ * Lock profile of a channel, per operation type
+ */
+struct LockProfile {
+    bool enabled = false;
+    LockOpProfile write;
+    LockOpProfile read;
+    LockOpProfile query;
+};
+
+namespace detail {
+
+// Plain copies of the shared counter blocks (also used by the read-only inspector)
+inline ChannelStats loadStats(const ChannelStatsBlock& block) {
+    ChannelStats stats;
+    stats.writes = block.writes.load(std::memory_order_relaxed);
+    stats.bytes_written = block.bytes_written.load(std::memory_order_relaxed);
+    stats.reads = block.reads.load(std::memory_order_relaxed);
+    stats.failed_reads = block.failed_reads.load(std::memory_order_relaxed);
+    stats.lock_acquisitions = block.lock_acquisitions.load(std::memory_order_relaxed);
+    stats.contended_acquisitions = block.contended_acquisitions.load(std::memory_order_relaxed);
+    stats.lock_wait_ns = block.lock_wait_ns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline LockProfile loadLockProfile(const LockProfileBlock& block) {
+    LockProfile profile;
+    profile.enabled = block.enabled.load(std::memory_order_relaxed) != 0;
+    LockOpProfile* ops[LOCK_OP_COUNT] = {&profile.write, &profile.read, &profile.query};
+    for (size_t op = 0; op < LOCK_OP_COUNT; ++op) {
+        const LockOpProfileBlock& from = block.ops[op];
+        LockOpProfile& to = *ops[op];
+        to.count = from.count.load(std::memory_order_relaxed);
+        to.total_wait_ns = from.total_wait_ns.load(std::memory_order_relaxed);
+        to.total_hold_ns = from.total_hold_ns.load(std::memory_order_relaxed);
+        to.max_wait_ns = from.max_wait_ns.load(std::memory_order_relaxed);
+        to.max_hold_ns = from.max_hold_ns.load(std::memory_order_relaxed);
+        to.max_wait_pid = from.max_wait_pid.load(std::memory_order_relaxed);
+        to.max_hold_pid = from.max_hold_pid.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < LOCK_HISTOGRAM_BUCKETS; ++i) {
+            to.wait_histogram[i] = from.wait_histogram[i].load(std::memory_order_relaxed);
+            to.hold_histogram[i] = from.hold_histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+    return profile;
+}
+
+// Adds the calling thread's allocations between construction and destruction
+// to a call counter; compiles to nothing without SHM_TRACK_ALLOCATIONS
+class AllocationScope {
+public:
+#if defined(SHM_TRACK_ALLOCATIONS)
+    AllocationScope(uint64_t& calls, uint64_t& allocations, uint64_t& bytes)
+        : calls_(calls), allocations_(allocations), bytes_(bytes),
+          start_count_(thread_allocations.count), start_bytes_(thread_allocations.bytes) {}
+
+    ~AllocationScope() {
+        calls_++;
+        allocations_ += thread_allocations.count - start_count_;
+        bytes_ += thread_allocations.bytes - start_bytes_;
+    }
+
+private:
+    uint64_t& calls_;
+    uint64_t& allocations_;
+    uint64_t& bytes_;
+    uint64_t start_count_;
+    uint64_t start_bytes_;
+#else
+    AllocationScope(uint64_t&, uint64_t&, uint64_t&) {}
+#endif
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+// Deadline timeout_ms from now. Timeouts beyond ~100 years (e.g. UINT64_MAX for
+// "forever") are clamped, since they would overflow the clock's nanosecond count.
+inline std::chrono::steady_clock::time_point deadlineAfter(uint64_t timeout_ms) {
+    const uint64_t max_timeout_ms = 100ull * 365 * 24 * 3600 * 1000;
+    return std::chrono::steady_clock::now() +
+           std::chrono::milliseconds(timeout_ms < max_timeout_ms ? timeout_ms : max_timeout_ms);
+}
+
+#if defined(__linux__)
+// Shared (not FUTEX_PRIVATE) futex calls so waiters in other processes are woken
+inline long futexWait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace detail
+
+class ChannelSet;
+class BusyPollReader;
 constexpr size_t HEADER_SIZE = sizeof(SharedMemoryHeader);
 
+/**
+ * Optional settings for SharedMemoryJSON
+ */
+struct ChannelOptions {
+    // Back the channel with this regular file (on disk or tmpfs) instead of
+    // anonymous shared memory. Every process must pass the same path. The
+    // creator reopens an existing file instead of wiping it, so the last
+    // published data and sequence number survive restarts; neither the file
+    // nor the channel's lock is deleted by the library (see
+    // SharedMemoryJSON::removeBackingLock()).
+    std::string backing_path;
+};
+
 class SharedMemoryJSON {
 public:
     /**
@@ -45,16 +401,37 @@ public:
      * @param create If true, create new shared memory; if false, open existing
      */
     SharedMemoryJSON(const std::string& name, size_t max_size, bool create = true)
+        : SharedMemoryJSON(name, max_size, create, ChannelOptions())
+    {
+    }
+
+    /**
+     * Constructor with options
+     * @param name Unique name for the shared memory region (also names the lock)
+     * @param max_size Maximum size for JSON data (excluding header)
+     * @param create If true, create (or, when file-backed, reopen) the channel; if false, open existing
+     * @param options See ChannelOptions
+     *
+     * @note A file-backed creator keeps the file's contents if its header is valid
+     *       for this max_size and PROTOCOL_VERSION (see wasRestored()). Data torn by
+     *       a writer that crashed mid-write is discarded, but the sequence number
+     *       carries on. Otherwise the file is reset like a new channel.
+     */
+    SharedMemoryJSON(const std::string& name, size_t max_size, bool create, const ChannelOptions& options)
         : name_(name)
         , max_data_size_(max_size)
         , total_size_(HEADER_SIZE + max_size)
         , is_creator_(create)
+        , backing_path_(options.backing_path)
     {
 #ifdef _WIN32
         initWindows(create);
 #else
         initPosix(create);
 #endif
+        if (!create) {
+            registerReader();
+        }
     }
 
     ~SharedMemoryJSON() {
@@ -71,37 +448,70 @@ public:
      * @return true if successful, false otherwise
      */
     bool write(const json& data) {
-        try {
-            std::string serialized = data.dump();
-            
-            if (serialized.size() > max_data_size_) {
-                throw std::runtime_error("JSON data too large for shared memory region");
-            }
+        uint64_t sequence;
+        return write(data, sequence);
+    }
 
-            lock();
-            
-            // Get header pointer
-            SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
-            
-            // Update header
-            header->magic_number = MAGIC_NUMBER;
-            header->version = PROTOCOL_VERSION;
-            header->data_size = serialized.size();
-            header->sequence_number++;
-            header->timestamp = getCurrentTimestamp();
-            
-            // Write JSON data after header
-            char* data_ptr = reinterpret_cast<char*>(mapped_ptr_) + HEADER_SIZE;
-            std::memcpy(data_ptr, serialized.c_str(), serialized.size());
-            
-            unlock();
-            return true;
-            
+    /**
+     * Write JSON data and report the sequence number it was published at
+     * @param data JSON object to write
+     * @param sequence Output parameter for the assigned sequence number
+     * @return true if successful, false otherwise
+     */
+    bool write(const json& data, uint64_t& sequence) {
+        detail::AllocationScope allocations(allocation_stats_.writes, allocation_stats_.write_allocations,
+                                            allocation_stats_.write_bytes);
+        std::string serialized;
+        try {
+            serialized = data.dump();
         } catch (const std::exception& e) {
-            unlock();
             last_error_ = e.what();
             return false;
         }
+        return publish(serialized.data(), serialized.size(), sequence);
+    }
+
+    /**
+     * Publish already serialized JSON text as is
+     * @param payload Serialized JSON, e.g. from readSerialized() or a recording
+     * @param sequence Output parameter for the assigned sequence number
+     * @return true if successful, false otherwise
+     *
+     * @note The payload is not validated; readers fail to parse anything that
+     *       is not JSON. Skips the dump() of write(), so republishing recorded
+     *       or forwarded payloads costs one memcpy.
+     */
+    bool writeSerialized(const std::string& payload, uint64_t& sequence) {
+        detail::AllocationScope allocations(allocation_stats_.writes, allocation_stats_.write_allocations,
+                                            allocation_stats_.write_bytes);
+        return publish(payload.data(), payload.size(), sequence);
+    }
+
+    bool writeSerialized(const std::string& payload) {
+        uint64_t sequence;
+        return writeSerialized(payload, sequence);
+    }
+
+    /**
+     * Publish serialized JSON under a given sequence number and timestamp
+     * @param payload Serialized JSON, e.g. from a checkpoint or another channel
+     * @param size Payload length in bytes
+     * @param sequence Sequence number to publish at; must be above the current one
+     * @param timestamp Write time to record (microseconds since epoch, 0 = now)
+     * @return true if successful, false otherwise
+     *
+     * @note For restoring saved state and mirroring channels so that readers
+     *       see the original sequence numbers. Later write() calls continue
+     *       from this sequence.
+     */
+    bool republish(const char* payload, size_t size, uint64_t sequence, uint64_t timestamp = 0) {
+        detail::AllocationScope allocations(allocation_stats_.writes, allocation_stats_.write_allocations,
+                                            allocation_stats_.write_bytes);
+        return publish(payload, size, sequence, true, timestamp);
+    }
+
+    bool republish(const std::string& payload, uint64_t sequence, uint64_t timestamp = 0) {
+        return republish(payload.data(), payload.size(), sequence, timestamp);
     }
 
     /**
@@ -110,8 +520,35 @@ public:
      * @return true if successful, false otherwise
      */
     bool read(json& data) {
+        uint64_t sequence;
+        return read(data, sequence);
+    }
+
+    /**
+     * Read JSON data together with the sequence number it was written at
+     * @param data Output parameter for JSON object
+     * @param sequence Output parameter for the sequence number of data
+     * @return true if successful, false otherwise
+     */
+    bool read(json& data, uint64_t& sequence) {
+        uint64_t timestamp;
+        return read(data, sequence, timestamp);
+    }
+
+    /**
+     * Read JSON data together with its sequence number and write timestamp
+     * @param data Output parameter for JSON object
+     * @param sequence Output parameter for the sequence number of data
+     * @param timestamp Output parameter for the write time of data (microseconds since epoch)
+     * @return true if successful, false otherwise
+     */
+    bool read(json& data, uint64_t& sequence, uint64_t& timestamp) {
+        detail::AllocationScope allocations(allocation_stats_.reads, allocation_stats_.read_allocations,
+                                            allocation_stats_.read_bytes);
+        touchHeartbeat();
+        SHM_PROBE1(read_start, name_.c_str());
         try {
-            lock();
+            lock(LockOp::Read);
             
             // Get header pointer
             SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
@@ -120,37 +557,84 @@ public:
             if (header->magic_number != MAGIC_NUMBER) {
                 unlock();
                 last_error_ = "Invalid magic number - shared memory not initialized";
+                countRead(false);
                 return false;
             }
             
             if (header->version != PROTOCOL_VERSION) {
                 unlock();
                 last_error_ = "Protocol version mismatch";
+                countRead(false);
                 return false;
             }
             
             if (header->data_size == 0) {
                 unlock();
                 last_error_ = "No data in shared memory";
+                countRead(false);
                 return false;
             }
             
             // Read JSON data
             char* data_ptr = reinterpret_cast<char*>(mapped_ptr_) + HEADER_SIZE;
             std::string serialized(data_ptr, header->data_size);
+            sequence = header->sequence_number.load();
+            timestamp = header->timestamp;
             
             data = json::parse(serialized);
             
             unlock();
+            countRead(true, sequence, serialized.size());
             return true;
             
         } catch (const std::exception& e) {
             unlock();
             last_error_ = e.what();
+            countRead(false);
             return false;
         }
     }
 
+    /**
+     * Copy the serialized JSON payload without taking the lock
+     * @param payload Output parameter for the serialized JSON text
+     * @param sequence Output parameter for the sequence number of payload
+     * @param timestamp Output parameter for the write time of payload (microseconds since epoch)
+     * @param max_attempts Copies to try before giving up while a writer keeps interfering
+     * @return true if a consistent copy was taken, false otherwise
+     *
+     * @note Consistency is validated with the header's seqlock counter, so readers
+     *       never block writers or each other. Parse the payload with json::parse().
+     */
+    bool readSerialized(std::string& payload, uint64_t& sequence, uint64_t& timestamp,
+                        unsigned max_attempts = 1000) {
+        detail::AllocationScope allocations(allocation_stats_.reads, allocation_stats_.read_allocations,
+                                            allocation_stats_.read_bytes);
+        touchHeartbeat();
+        SHM_PROBE1(read_start, name_.c_str());
+        for (unsigned attempt = 0; attempt < max_attempts; ++attempt) {
+            uint64_t counter;
+            if (!seqlockBegin(counter)) {
+                countRead(false);
+                return false;
+            }
+            if (counter & 1) {
+                std::this_thread::yield(); // Write in progress
+                continue;
+            }
+            if (!seqlockCopy(payload, sequence, timestamp)) {
+                continue; // Size field torn by a concurrent write
+            }
+            if (seqlockValidate(counter)) {
+                countRead(true, sequence, payload.size());
+                return true;
+            }
+        }
+        last_error_ = "Writer kept interfering with lock-free read";
+        countRead(false);
+        return false;
+    }
+
     /**
      * Read with timeout - waits for new data (based on sequence number)
      * @param data Output parameter for JSON object
@@ -162,31 +646,58 @@ public:
      *       (after ~584 years at 1B writes/sec), one update may be missed.
      */
     bool readWithTimeout(json& data, uint64_t timeout_ms, uint64_t last_seq = 0) {
-        auto start = std::chrono::steady_clock::now();
-        
+        if (!waitForUpdate(last_seq, timeout_ms)) {
+            last_error_ = "Timeout waiting for new data";
+            return false;
+        }
+        return read(data);
+    }
+
+    /**
+     * Block until the sequence number moves past last_seq, without taking the lock
+     * @param last_seq Last sequence number seen (0 to accept any written data)
+     * @param timeout_ms Timeout in milliseconds
+     * @return true if newer data is available, false on timeout
+     *
+     * @note On Linux this sleeps on a futex in the shared header and wakes as soon
+     *       as a writer publishes; elsewhere it polls every 10 ms.
+     */
+    bool waitForUpdate(uint64_t last_seq, uint64_t timeout_ms) {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        auto deadline = detail::deadlineAfter(timeout_ms);
+        bool slept = false;
+
         while (true) {
-            lock();
-            SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
-            
-            if (header->magic_number == MAGIC_NUMBER && 
-                header->data_size > 0 && 
-                header->sequence_number > last_seq) {
-                unlock();
-                return read(data);
+            uint64_t sequence = header->sequence_number.load(std::memory_order_acquire);
+            if (sequence > last_seq) {
+                if (slept) {
+                    SHM_PROBE3(wait_wakeup, name_.c_str(), last_seq, sequence);
+                }
+                return true;
             }
-            
-            unlock();
-            
-            auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start
-            ).count());
 
-            if (elapsed >= timeout_ms) {
-                last_error_ = "Timeout waiting for new data";
+            touchHeartbeat();
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                SHM_PROBE2(wait_timeout, name_.c_str(), last_seq);
                 return false;
             }
-            
+            slept = true;
+
+#if defined(__linux__)
+            header->waiter_count.fetch_add(1);
+            uint32_t word = header->notify_word.load();
+            if (header->sequence_number.load() <= last_seq) {
+                auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+                timespec timeout;
+                timeout.tv_sec = static_cast<time_t>(remaining / 1000000000);
+                timeout.tv_nsec = static_cast<long>(remaining % 1000000000);
+                detail::futexWait(&header->notify_word, word, &timeout);
+            }
+            header->waiter_count.fetch_sub(1);
+#else
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
         }
     }
 
@@ -194,13 +705,262 @@ public:
      * Get the current sequence number without reading data
      */
     uint64_t getSequenceNumber() {
-        lock();
+        lock(LockOp::Query);
         SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
-        uint64_t seq = header->sequence_number;
+        uint64_t seq = header->sequence_number.load();
         unlock();
         return seq;
     }
 
+    /**
+     * Get the current sequence number without taking the lock
+     *
+     * @note Never waits, so it suits polling loops and code that must not
+     *       stall behind the writer. Like getSequenceNumber(), the value can be
+     *       outdated as soon as it is returned.
+     */
+    uint64_t peekSequenceNumber() const {
+        const SharedMemoryHeader* header = reinterpret_cast<const SharedMemoryHeader*>(mapped_ptr_);
+        return header->sequence_number.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Check whether any reader is attached to this channel
+     * @param max_idle_ms Only count readers that read or waited within this window (0 = any live reader)
+     * @return true if at least one reader process is alive
+     *
+     * @note Readers register when opened with create=false. Slots of processes
+     *       that exited without cleaning up are released here.
+     */
+    bool hasActiveReaders(uint64_t max_idle_ms = 0) {
+        return countReaders(max_idle_ms, true) > 0;
+    }
+
+    /**
+     * Number of attached readers (same rules as hasActiveReaders())
+     */
+    size_t getActiveReaderCount(uint64_t max_idle_ms = 0) {
+        return countReaders(max_idle_ms, false);
+    }
+
+    /**
+     * Get a file descriptor that becomes readable when a new sequence is published
+     * @return fd usable with poll/epoll/select, or -1 on error (see getLastError())
+     *
+     * @note Linux only. The fd is owned by this object and closed on destruction.
+     *       Call consumeNotifications() once it becomes readable to re-arm it.
+     */
+    int getNotifyFd() {
+#if defined(__linux__)
+        if (notify_fd_ != -1) {
+            return notify_fd_;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            last_error_ = "Failed to create notify socket: " + std::string(strerror(errno));
+            return -1;
+        }
+
+        uint64_t value = (static_cast<uint64_t>(getpid()) << 32) | nextNotifyToken();
+        sockaddr_un addr;
+        socklen_t addr_len = makeNotifyAddress(value, addr);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), addr_len) == -1) {
+            last_error_ = "Failed to bind notify socket: " + std::string(strerror(errno));
+            close(fd);
+            return -1;
+        }
+
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        for (size_t i = 0; i < MAX_NOTIFY_SUBSCRIBERS; ++i) {
+            uint64_t expected = 0;
+            if (header->notify_slots[i].compare_exchange_strong(expected, value)) {
+                notify_fd_ = fd;
+                notify_slot_ = i;
+                notify_value_ = value;
+                return notify_fd_;
+            }
+        }
+
+        close(fd);
+        last_error_ = "Too many notify subscribers on this channel";
+        return -1;
+#else
+        last_error_ = "Notify fd is not supported on this platform";
+        return -1;
+#endif
+    }
+
+    /**
+     * Drain pending notifications so the notify fd stops polling readable
+     */
+    void consumeNotifications() {
+#if defined(__linux__)
+        if (notify_fd_ == -1) {
+            return;
+        }
+        char buffer[64];
+        while (recv(notify_fd_, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+        }
+#endif
+    }
+
+    /**
+     * Get the channel's live counters, aggregated over every process using it
+     *
+     * @note Counters are read without the lock, so fields may be a few
+     *       operations apart from each other. They start at zero when the
+     *       writer creates the channel.
+     */
+    ChannelStats getStats() const {
+        return detail::loadStats(reinterpret_cast<const SharedMemoryHeader*>(mapped_ptr_)->stats);
+    }
+
+    /**
+     * Turn lock profiling on or off for every process using the channel
+     *
+     * @note While enabled, every lock()/unlock() pair is timestamped and the wait
+     *       and hold times are recorded per operation type in the shared header.
+     *       This costs two clock reads and a handful of relaxed atomics per
+     *       acquisition; disabled, it costs one relaxed load.
+     */
+    void enableLockProfiling(bool enabled) {
+        sharedHeader()->lock_profile.enabled.store(enabled ? 1 : 0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Get wait/hold histograms recorded while profiling was enabled
+     */
+    LockProfile getLockProfile() const {
+        return detail::loadLockProfile(reinterpret_cast<const SharedMemoryHeader*>(mapped_ptr_)->lock_profile);
+    }
+
+    /**
+     * Clear the recorded lock profile (profiling stays enabled or disabled)
+     */
+    void resetLockProfile() {
+        for (LockOpProfileBlock& block : sharedHeader()->lock_profile.ops) {
+            block.count.store(0, std::memory_order_relaxed);
+            block.total_wait_ns.store(0, std::memory_order_relaxed);
+            block.total_hold_ns.store(0, std::memory_order_relaxed);
+            block.max_wait_ns.store(0, std::memory_order_relaxed);
+            block.max_hold_ns.store(0, std::memory_order_relaxed);
+            block.max_wait_pid.store(0, std::memory_order_relaxed);
+            block.max_hold_pid.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < LOCK_HISTOGRAM_BUCKETS; ++i) {
+                block.wait_histogram[i].store(0, std::memory_order_relaxed);
+                block.hold_histogram[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Get allocations made by this instance's write() and read() calls
+     *
+     * @note Always zero unless built with SHM_TRACK_ALLOCATIONS and the program
+     *       expands SHM_DEFINE_ALLOCATION_HOOKS() (see ALLOCATION_TRACKING).
+     */
+    AllocationStats getAllocationStats() const {
+        return allocation_stats_;
+    }
+
+    /**
+     * Clear the allocation counters of this instance
+     */
+    void resetAllocationStats() {
+        allocation_stats_ = AllocationStats();
+    }
+
+    /**
+     * Whether the region this instance mapped has been removed or replaced
+     * @return true if the channel name (or backing file) no longer refers to it
+     *
+     * @note A creator that restarts unlinks the region and creates a new one,
+     *       while instances opened earlier stay mapped to the old region and
+     *       never see another write. Long-running readers can call this now
+     *       and then (it costs a system call) and reopen the channel. Always
+     *       false on Windows, where a named mapping lives until its last handle
+     *       closes and a new creator reopens it.
+     */
+    bool isReplaced() const {
+#ifdef _WIN32
+        return false;
+#else
+        struct stat mapped;
+        if (fstat(shm_fd_, &mapped) == -1) {
+            return false;
+        }
+        struct stat current;
+        if (!backing_path_.empty()) {
+            if (stat(backing_path_.c_str(), &current) == -1) {
+                return errno == ENOENT;
+            }
+        } else {
+            int fd = shm_open(("/" + name_).c_str(), O_RDONLY, 0);
+            if (fd == -1) {
+                return errno == ENOENT;
+            }
+            int result = fstat(fd, &current);
+            close(fd);
+            if (result == -1) {
+                return false;
+            }
+        }
+        return current.st_dev != mapped.st_dev || current.st_ino != mapped.st_ino;
+#endif
+    }
+
+    /**
+     * Whether this creator resumed the data of a file-backed channel
+     * (false for channels created empty or opened with create=false)
+     */
+    bool wasRestored() const {
+        return restored_;
+    }
+
+    /**
+     * Flush a file-backed channel to its file and wait for the write to complete
+     * @return true on success (always true for channels in shared memory)
+     *
+     * @note Not needed to survive process restarts - the page cache already
+     *       holds the data - only to survive an OS crash or power loss.
+     */
+    bool sync() {
+        if (backing_path_.empty()) {
+            return true;
+        }
+#ifdef _WIN32
+        bool ok = FlushViewOfFile(mapped_ptr_, total_size_) && FlushFileBuffers(file_handle_);
+#else
+        bool ok = msync(mapped_ptr_, total_size_, MS_SYNC) == 0;
+#endif
+        if (!ok) {
+            last_error_ = "Failed to flush backing file";
+        }
+        return ok;
+    }
+
+    /**
+     * Remove the lock of a file-backed channel that is no longer in use
+     * @param name Channel name
+     * @param backing_path Backing file the channel was opened with
+     * @return true if the lock was removed or did not exist
+     *
+     * @note A file-backed channel keeps its lock (a named semaphore) after its
+     *       creator exits, so readers stay in sync across restarts. Call this
+     *       when retiring the channel; the backing file is left alone. On
+     *       Windows the lock disappears with its last handle and this does nothing.
+     */
+    static bool removeBackingLock(const std::string& name, const std::string& backing_path) {
+#ifdef _WIN32
+        (void)name;
+        (void)backing_path;
+        return true;
+#else
+        return sem_unlink(semaphoreName(name, backing_path).c_str()) == 0 || errno == ENOENT;
+#endif
+    }
+
     /**
      * Get last error message
      */
@@ -215,14 +975,397 @@ public:
         return max_data_size_;
     }
 
+    /**
+     * Get the channel name
+     */
+    const std::string& getName() const {
+        return name_;
+    }
+
 private:
+    friend class ChannelSet;
+    friend class BusyPollReader;
+
     std::string name_;
     size_t max_data_size_;
     size_t total_size_;
     bool is_creator_;
+    std::string backing_path_;     // Empty for channels in shared memory
+    bool restored_ = false;
     std::string last_error_;
+    AllocationStats allocation_stats_;
+
+    // Seqlock read protocol: begin -> copy -> validate (also used by ChannelSet::snapshot()).
+    // An odd counter means a write is in progress and the copy must be retried.
+    bool seqlockBegin(uint64_t& counter) {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        counter = header->write_counter.load(std::memory_order_acquire);
+        if (header->magic_number.load(std::memory_order_relaxed) != MAGIC_NUMBER) {
+            last_error_ = "Invalid magic number - shared memory not initialized";
+            return false;
+        }
+        if (header->version.load(std::memory_order_relaxed) != PROTOCOL_VERSION) {
+            last_error_ = "Protocol version mismatch";
+            return false;
+        }
+        return true;
+    }
+
+    bool seqlockCopy(std::string& payload, uint64_t& sequence, uint64_t& timestamp) {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        uint64_t size = header->data_size.load(std::memory_order_relaxed);
+        if (size > max_data_size_) {
+            return false;
+        }
+        const char* data_ptr = reinterpret_cast<const char*>(mapped_ptr_) + HEADER_SIZE;
+        payload.assign(data_ptr, size);
+        sequence = header->sequence_number.load(std::memory_order_relaxed);
+        timestamp = header->timestamp.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    bool seqlockValidate(uint64_t counter) {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return header->write_counter.load(std::memory_order_relaxed) == counter;
+    }
+
+    // Called once per read()/readSerialized() call with its outcome
+    void countRead(bool ok, uint64_t sequence = 0, uint64_t bytes = 0) {
+        ChannelStatsBlock& stats = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_)->stats;
+        (ok ? stats.reads : stats.failed_reads).fetch_add(1, std::memory_order_relaxed);
+        SHM_PROBE4(read_finish, name_.c_str(), sequence, bytes, ok ? 1 : 0);
+    }
+
+    // Creator of a file-backed channel: keep the previous run's state if the
+    // header is valid for this layout, otherwise start empty. Runs under the
+    // lock, since readers may have stayed attached across the restart.
+    void restoreOrReset(bool size_matches) {
+        // The previous creator may have died holding the lock
+        releaseAbandonedLock();
+        lock(LockOp::Write);
+
+        SharedMemoryHeader* header = sharedHeader();
+        if (!size_matches || header->magic_number.load() != MAGIC_NUMBER ||
+            header->version.load() != PROTOCOL_VERSION || header->data_size.load() > max_data_size_) {
+            // Not a channel of this layout: nothing attached can be using it
+            std::memset(mapped_ptr_, 0, total_size_);
+            unlock();
+            return;
+        }
+
+        // Slots persisted across a reboot hold pids that may since have been
+        // reused; a heartbeat from before the boot gives them away
+        uint64_t booted_at = bootTimestamp();
+        for (auto& slot : header->readers) {
+            uint32_t pid = slot.pid.load();
+            if (pid != 0 && slot.heartbeat.load(std::memory_order_relaxed) < booted_at) {
+                slot.pid.compare_exchange_strong(pid, 0);
+            }
+        }
+        countReaders(0, false); // Drops the slots of dead readers
+        for (auto& slot : header->notify_slots) {
+            uint64_t value = slot.load();
+            if (value != 0 && !processAlive(static_cast<uint32_t>(value >> 32))) {
+                slot.compare_exchange_strong(value, 0);
+            }
+        }
+
+        uint64_t counter = header->write_counter.load();
+        if (counter & 1) {
+            // The previous writer died mid-write: the data is torn. Only the
+            // payload fields are cleared so attached readers see a normal update.
+            header->data_size.store(0);
+            header->write_counter.store(counter + 1);
+        } else {
+            restored_ = true;
+        }
+        unlock();
+    }
+
+    // Copy a serialized payload into the region under the lock (shared by the write paths).
+    // Assigns the next sequence number unless keep_sequence is set (republish()).
+    bool publish(const char* payload, size_t size, uint64_t& sequence, bool keep_sequence = false,
+                 uint64_t timestamp = 0) {
+        SHM_PROBE2(write_start, name_.c_str(), size);
+        if (size > max_data_size_) {
+            last_error_ = "JSON data too large for shared memory region";
+            return false;
+        }
+
+        lock(LockOp::Write);
+        
+        // Get header pointer
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        
+        if (keep_sequence && sequence <= header->sequence_number.load(std::memory_order_relaxed)) {
+            unlock();
+            last_error_ = "Sequence number must be above the current one";
+            return false;
+        }
+        
+        // Mark the write in progress for lock-free readers
+        uint64_t counter = header->write_counter.load(std::memory_order_relaxed);
+        header->write_counter.store(counter + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        // Update header
+        header->magic_number.store(MAGIC_NUMBER, std::memory_order_relaxed);
+        header->version.store(PROTOCOL_VERSION, std::memory_order_relaxed);
+        header->data_size.store(size, std::memory_order_relaxed);
+        if (keep_sequence) {
+            header->sequence_number.store(sequence, std::memory_order_relaxed);
+        } else {
+            sequence = header->sequence_number.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        header->timestamp.store(timestamp ? timestamp : getCurrentTimestamp(), std::memory_order_relaxed);
+        
+        // Write JSON data after header
+        char* data_ptr = reinterpret_cast<char*>(mapped_ptr_) + HEADER_SIZE;
+        std::memcpy(data_ptr, payload, size);
+        
+        header->write_counter.store(counter + 2, std::memory_order_release);
+        header->stats.writes.fetch_add(1, std::memory_order_relaxed);
+        header->stats.bytes_written.fetch_add(size, std::memory_order_relaxed);
+        
+        unlock();
+        SHM_PROBE3(write_commit, name_.c_str(), sequence, size);
+        wakeWaiters(header);
+        notifySubscribers();
+        return true;
+    }
+
+    SharedMemoryHeader* sharedHeader() {
+        return reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+    }
+
+    // State of the current hold; only touched while the lock is held
+    LockOp held_op_ = LockOp::Query;
+    bool profiling_hold_ = false;
+    std::chrono::steady_clock::time_point acquired_at_;
+
+    void lock(LockOp op) {
+        SharedMemoryHeader* shared = sharedHeader();
+        bool profiling = shared->lock_profile.enabled.load(std::memory_order_relaxed) != 0;
+        std::chrono::steady_clock::time_point start;
+        if (profiling) {
+            start = std::chrono::steady_clock::now();
+        }
+
+        // Try first so only acquisitions that actually block pay for the clock reads
+        bool contended = !tryAcquire();
+        if (contended) {
+            if (!profiling) {
+                start = std::chrono::steady_clock::now();
+            }
+            acquire();
+        }
+
+        uint64_t wait_ns = 0;
+        if (profiling || contended) {
+            acquired_at_ = std::chrono::steady_clock::now();
+            wait_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(acquired_at_ - start).count());
+        }
+
+        ChannelStatsBlock& stats = shared->stats;
+        stats.lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (contended) {
+            stats.contended_acquisitions.fetch_add(1, std::memory_order_relaxed);
+            stats.lock_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+        }
+
+        SHM_PROBE3(lock_acquire, name_.c_str(), static_cast<uint32_t>(op), wait_ns);
+        shared->lock_owner.store(currentProcessId(), std::memory_order_relaxed);
+        held_op_ = op;
+        profiling_hold_ = profiling;
+        if (profiling) {
+            LockOpProfileBlock& block = shared->lock_profile.ops[static_cast<size_t>(op)];
+            block.count.fetch_add(1, std::memory_order_relaxed);
+            block.total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+            block.wait_histogram[histogramBucket(wait_ns)].fetch_add(1, std::memory_order_relaxed);
+            if (raiseMax(block.max_wait_ns, wait_ns)) {
+                block.max_wait_pid.store(currentProcessId(), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void unlock() {
+        SHM_PROBE2(lock_release, name_.c_str(), static_cast<uint32_t>(held_op_));
+        sharedHeader()->lock_owner.store(0, std::memory_order_relaxed);
+        if (!profiling_hold_) {
+            release();
+            return;
+        }
+        profiling_hold_ = false;
+        LockOp op = held_op_;
+        uint64_t hold_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - acquired_at_).count());
+        release();
+
+        LockOpProfileBlock& block = sharedHeader()->lock_profile.ops[static_cast<size_t>(op)];
+        block.total_hold_ns.fetch_add(hold_ns, std::memory_order_relaxed);
+        block.hold_histogram[histogramBucket(hold_ns)].fetch_add(1, std::memory_order_relaxed);
+        if (raiseMax(block.max_hold_ns, hold_ns)) {
+            block.max_hold_pid.store(currentProcessId(), std::memory_order_relaxed);
+        }
+    }
+
+    static size_t histogramBucket(uint64_t ns) {
+        size_t bucket = 0;
+        while (ns > 1 && bucket + 1 < LOCK_HISTOGRAM_BUCKETS) {
+            ns >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    // Returns true if value became the new maximum
+    static bool raiseMax(std::atomic<uint64_t>& maximum, uint64_t value) {
+        uint64_t current = maximum.load(std::memory_order_relaxed);
+        while (value > current) {
+            if (maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ReaderSlot* reader_slot_ = nullptr;
+
+    void registerReader() {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        uint32_t pid = currentProcessId();
+        for (int attempt = 0; attempt < 2 && !reader_slot_; ++attempt) {
+            for (auto& slot : header->readers) {
+                uint32_t expected = 0;
+                if (slot.pid.compare_exchange_strong(expected, pid)) {
+                    slot.heartbeat.store(getCurrentTimestamp(), std::memory_order_relaxed);
+                    reader_slot_ = &slot;
+                    break;
+                }
+            }
+            if (!reader_slot_) {
+                countReaders(0, false); // Table full: release slots of dead processes and retry
+            }
+        }
+        // If the table is still full this reader simply isn't tracked
+    }
+
+    void unregisterReader() {
+        if (reader_slot_) {
+            reader_slot_->pid.store(0);
+            reader_slot_ = nullptr;
+        }
+    }
+
+    void touchHeartbeat() {
+        if (reader_slot_) {
+            reader_slot_->heartbeat.store(getCurrentTimestamp(), std::memory_order_relaxed);
+        }
+    }
+
+    size_t countReaders(uint64_t max_idle_ms, bool stop_at_first) {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        uint64_t now = getCurrentTimestamp();
+        size_t count = 0;
+        for (auto& slot : header->readers) {
+            uint32_t pid = slot.pid.load();
+            if (pid == 0) {
+                continue;
+            }
+            if (!processAlive(pid)) {
+                slot.pid.compare_exchange_strong(pid, 0);
+                continue;
+            }
+            uint64_t heartbeat = slot.heartbeat.load(std::memory_order_relaxed);
+            uint64_t idle_us = now > heartbeat ? now - heartbeat : 0;
+            if (max_idle_ms != 0 && idle_us > max_idle_ms * 1000) {
+                continue;
+            }
+            count++;
+            if (stop_at_first) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    static void wakeWaiters(SharedMemoryHeader* header) {
+        // seq_cst pairs with the waiter_count increment in waitForUpdate()/ChannelSet::waitAny()
+        header->notify_word.fetch_add(1);
+#if defined(__linux__)
+        if (header->waiter_count.load() > 0) {
+            detail::futexWakeAll(&header->notify_word);
+        }
+#endif
+    }
+
+#if defined(__linux__)
+    int notify_fd_ = -1;           // Bound datagram socket returned by getNotifyFd()
+    int notify_send_fd_ = -1;      // Unbound socket used by writers to wake subscribers
+    size_t notify_slot_ = 0;
+    uint64_t notify_value_ = 0;
+
+    static uint32_t nextNotifyToken() {
+        static std::atomic<uint32_t> counter{0};
+        return ++counter;
+    }
+
+    // Subscribers live in the abstract socket namespace, keyed by pid and per-process token
+    static socklen_t makeNotifyAddress(uint64_t value, sockaddr_un& addr) {
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        int len = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "shm_json.%u.%u",
+                           static_cast<unsigned>(value >> 32), static_cast<unsigned>(value & 0xffffffffu));
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + len);
+    }
+
+    void notifySubscribers() {
+        SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+        for (auto& slot : header->notify_slots) {
+            uint64_t value = slot.load(std::memory_order_acquire);
+            if (value == 0) {
+                continue;
+            }
+            if (notify_send_fd_ == -1) {
+                notify_send_fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+                if (notify_send_fd_ == -1) {
+                    return;
+                }
+            }
+            sockaddr_un addr;
+            socklen_t addr_len = makeNotifyAddress(value, addr);
+            char byte = 0;
+            if (sendto(notify_send_fd_, &byte, 1, MSG_DONTWAIT | MSG_NOSIGNAL,
+                       reinterpret_cast<sockaddr*>(&addr), addr_len) == -1 &&
+                (errno == ECONNREFUSED || errno == ENOENT)) {
+                // Subscriber exited without unregistering
+                slot.compare_exchange_strong(value, 0);
+            }
+            // EAGAIN means the subscriber already has unread notifications
+        }
+    }
+
+    void closeNotify() {
+        if (notify_fd_ != -1) {
+            SharedMemoryHeader* header = reinterpret_cast<SharedMemoryHeader*>(mapped_ptr_);
+            uint64_t expected = notify_value_;
+            header->notify_slots[notify_slot_].compare_exchange_strong(expected, 0);
+            close(notify_fd_);
+            notify_fd_ = -1;
+        }
+        if (notify_send_fd_ != -1) {
+            close(notify_send_fd_);
+            notify_send_fd_ = -1;
+        }
+    }
+#else
+    void notifySubscribers() {}
+    void closeNotify() {}
+#endif
 
 #ifdef _WIN32
+    HANDLE file_handle_ = INVALID_HANDLE_VALUE;
     HANDLE file_mapping_;
     HANDLE mutex_;
     void* mapped_ptr_;
@@ -237,7 +1380,32 @@ private:
             throw std::runtime_error("Failed to create mutex");
         }
 
-        if (create) {
+        bool size_matches = false;
+        if (!backing_path_.empty()) {
+            file_handle_ = CreateFileA(backing_path_.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                       FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                       create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_handle_ == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("Failed to open backing file " + backing_path_);
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file_handle_, &size)) {
+                throw std::runtime_error("Failed to get size of backing file " + backing_path_);
+            }
+            size_matches = static_cast<uint64_t>(size.QuadPart) == total_size_;
+            if (!create && static_cast<uint64_t>(size.QuadPart) < total_size_) {
+                throw std::runtime_error("Backing file is smaller than the channel");
+            }
+            // Grows the file to total_size_ if needed
+            file_mapping_ = CreateFileMappingA(
+                file_handle_,
+                nullptr,
+                PAGE_READWRITE,
+                0,
+                static_cast<DWORD>(total_size_),
+                nullptr
+            );
+        } else if (create) {
             file_mapping_ = CreateFileMappingA(
                 INVALID_HANDLE_VALUE,
                 nullptr,
@@ -271,20 +1439,50 @@ private:
             throw std::runtime_error("Failed to map view of file");
         }
 
-        if (create) {
+        if (create && !backing_path_.empty()) {
+            restoreOrReset(size_matches);
+        } else if (create) {
             std::memset(mapped_ptr_, 0, total_size_);
         }
     }
 
-    void lock() {
+    // The mutex of a dead owner is abandoned and handed to the next waiter automatically
+    void releaseAbandonedLock() {}
+
+    // Wall-clock time of the last boot (microseconds since epoch)
+    static uint64_t bootTimestamp() {
+        return getCurrentTimestamp() - GetTickCount64() * 1000;
+    }
+
+    static uint32_t currentProcessId() {
+        return static_cast<uint32_t>(GetCurrentProcessId());
+    }
+
+    static bool processAlive(uint32_t pid) {
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+        if (!process) {
+            return GetLastError() == ERROR_ACCESS_DENIED;
+        }
+        bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+    }
+
+    bool tryAcquire() {
+        return WaitForSingleObject(mutex_, 0) == WAIT_OBJECT_0;
+    }
+
+    void acquire() {
         WaitForSingleObject(mutex_, INFINITE);
     }
 
-    void unlock() {
+    void release() {
         ReleaseMutex(mutex_);
     }
 
     void cleanup() {
+        closeNotify();
+        unregisterReader();
         if (mapped_ptr_) {
             UnmapViewOfFile(mapped_ptr_);
         }
@@ -294,6 +1492,9 @@ private:
         if (mutex_) {
             CloseHandle(mutex_);
         }
+        if (file_handle_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_handle_);
+        }
     }
 
 #else
@@ -302,11 +1503,39 @@ private:
     void* mapped_ptr_;
 
     void initPosix(bool create) {
-        std::string sem_name = "/sem_" + name_;
         std::string shm_name = "/" + name_;
 
-        // Create or open semaphore
-        if (create) {
+        // Open the backing file first: it names the semaphore
+        bool size_matches = false;
+        if (!backing_path_.empty()) {
+            shm_fd_ = open(backing_path_.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0666);
+            if (shm_fd_ == -1) {
+                throw std::runtime_error("Failed to open backing file " + backing_path_ + ": " +
+                                         std::string(strerror(errno)));
+            }
+
+            struct stat info;
+            if (fstat(shm_fd_, &info) == -1) {
+                close(shm_fd_);
+                throw std::runtime_error("Failed to stat backing file: " + std::string(strerror(errno)));
+            }
+            size_matches = static_cast<uint64_t>(info.st_size) == total_size_;
+            if (!create && static_cast<uint64_t>(info.st_size) < total_size_) {
+                close(shm_fd_);
+                throw std::runtime_error("Backing file is smaller than the channel");
+            }
+            if (create && !size_matches && ftruncate(shm_fd_, total_size_) == -1) {
+                close(shm_fd_);
+                throw std::runtime_error("Failed to set backing file size: " + std::string(strerror(errno)));
+            }
+        }
+
+        // Create or open semaphore. A file-backed channel keeps its semaphore across
+        // restarts so readers that stayed attached keep sharing the lock.
+        std::string sem_name = semaphoreName(name_, backing_path_);
+        if (create && !backing_path_.empty()) {
+            sem_ = sem_open(sem_name.c_str(), O_CREAT, 0666, 1);
+        } else if (create) {
             sem_unlink(sem_name.c_str()); // Clean up any existing semaphore
             sem_ = sem_open(sem_name.c_str(), O_CREAT | O_EXCL, 0666, 1);
         } else {
@@ -314,11 +1543,17 @@ private:
         }
 
         if (sem_ == SEM_FAILED) {
-            throw std::runtime_error("Failed to create/open semaphore: " + std::string(strerror(errno)));
+            int error = errno;
+            if (!backing_path_.empty()) {
+                close(shm_fd_);
+            }
+            throw std::runtime_error("Failed to create/open semaphore: " + std::string(strerror(error)));
         }
 
         // Create or open shared memory
-        if (create) {
+        if (!backing_path_.empty()) {
+            // Opened above
+        } else if (create) {
             shm_unlink(shm_name.c_str()); // Clean up any existing shared memory
             shm_fd_ = shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0666);
             if (shm_fd_ == -1) {
@@ -347,35 +1582,132 @@ private:
             throw std::runtime_error("Failed to map shared memory: " + std::string(strerror(errno)));
         }
 
-        if (create) {
+        if (create && !backing_path_.empty()) {
+            restoreOrReset(size_matches);
+        } else if (create) {
             std::memset(mapped_ptr_, 0, total_size_);
         }
     }
 
-    void lock() {
-        sem_wait(sem_);
+    // "/sem_<name>" for channels in shared memory. A file-backed channel adds a
+    // hash of its file's path, so it never shares (or gets unlinked by) the
+    // semaphore of a shared memory channel with the same name.
+    static std::string semaphoreName(const std::string& name, const std::string& backing_path) {
+        std::string sem_name = "/sem_" + name;
+        if (backing_path.empty()) {
+            return sem_name;
+        }
+
+        // Resolve the directory rather than the file, so the name can still be
+        // derived once the file is gone (see removeBackingLock())
+        std::string path = backing_path;
+        size_t slash = backing_path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : backing_path.substr(0, slash == 0 ? 1 : slash);
+        char resolved[PATH_MAX];
+        if (realpath(dir.c_str(), resolved)) {
+            path = std::string(resolved) + "/" + backing_path.substr(slash == std::string::npos ? 0 : slash + 1);
+        }
+
+        uint64_t hash = 14695981039346656037ULL; // FNV-1a
+        for (unsigned char c : path) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        char suffix[24];
+        snprintf(suffix, sizeof(suffix), ".f%016llx", static_cast<unsigned long long>(hash));
+        return sem_name + suffix;
     }
 
-    void unlock() {
+    // A semaphore held by a dead process is never posted. lock() records the
+    // holder's pid, so a holder that no longer exists can be detected and its
+    // hold released; a live holder is waited for, however long it takes.
+    void releaseAbandonedLock() {
+        SharedMemoryHeader* header = sharedHeader();
+        // A holder that died between sem_wait() and storing its pid leaves no
+        // owner to check; a live one stores it right away, so an ownerless hold
+        // lasting this long is treated as abandoned
+        const auto ownerless_limit = std::chrono::seconds(5);
+        auto ownerless_since = std::chrono::steady_clock::now();
+        for (;;) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += 100 * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            if (sem_timedwait(sem_, &deadline) == 0) {
+                sem_post(sem_); // Free (or just released): nothing to recover
+                return;
+            }
+            if (errno != ETIMEDOUT && errno != EINTR) {
+                return;
+            }
+            uint32_t owner = header->lock_owner.load();
+            if (owner != 0) {
+                ownerless_since = std::chrono::steady_clock::now();
+                if (!processAlive(owner) && header->lock_owner.compare_exchange_strong(owner, 0)) {
+                    sem_post(sem_); // Release the dead holder's hold
+                    return;
+                }
+            } else if (std::chrono::steady_clock::now() - ownerless_since >= ownerless_limit) {
+                sem_post(sem_);
+                return;
+            }
+        }
+    }
+
+    // Wall-clock time of the last boot (microseconds since epoch), 0 if unknown
+    static uint64_t bootTimestamp() {
+#if defined(__linux__)
+        struct timespec uptime;
+        if (clock_gettime(CLOCK_BOOTTIME, &uptime) == 0) {
+            uint64_t uptime_us = static_cast<uint64_t>(uptime.tv_sec) * 1000000 +
+                                 static_cast<uint64_t>(uptime.tv_nsec) / 1000;
+            uint64_t now = getCurrentTimestamp();
+            return now > uptime_us ? now - uptime_us : 0;
+        }
+#endif
+        return 0;
+    }
+
+    static uint32_t currentProcessId() {
+        return static_cast<uint32_t>(getpid());
+    }
+
+    static bool processAlive(uint32_t pid) {
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+    }
+
+    bool tryAcquire() {
+        return sem_trywait(sem_) == 0;
+    }
+
+    void acquire() {
+        while (sem_wait(sem_) == -1 && errno == EINTR) {
+        }
+    }
+
+    void release() {
         sem_post(sem_);
     }
 
     void cleanup() {
         if (mapped_ptr_ != MAP_FAILED) {
+            closeNotify();
+            unregisterReader();
             munmap(mapped_ptr_, total_size_);
         }
         if (shm_fd_ != -1) {
             close(shm_fd_);
-            if (is_creator_) {
+            if (is_creator_ && backing_path_.empty()) {
                 std::string shm_name = "/" + name_;
                 shm_unlink(shm_name.c_str());
             }
         }
         if (sem_ != SEM_FAILED) {
             sem_close(sem_);
-            if (is_creator_) {
-                std::string sem_name = "/sem_" + name_;
-                sem_unlink(sem_name.c_str());
+            if (is_creator_ && backing_path_.empty()) {
+                sem_unlink(semaphoreName(name_, backing_path_).c_str());
             }
         }
     }
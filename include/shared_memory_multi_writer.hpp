@@ -0,0 +1,250 @@
+#pragma once
+
+#include "shared_memory_json.hpp"
+#include "shared_memory_channel_set.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * Name of the shared memory channel backing one writer lane
+ */
+inline std::string laneChannelName(const std::string& name, size_t lane) {
+    return name + ".lane" + std::to_string(lane);
+}
+
+/**
+ * Writer side of a multi-writer channel.
+ *
+ * Every writer owns one lane: a separate region with its own semaphore and
+ * sequence number, so redundant writers never contend with or overwrite
+ * each other. Lane ids must be unique per writer (e.g. one per controller).
+ */
+class LaneWriter {
+public:
+    /**
+     * Constructor
+     * @param name Multi-writer channel name
+     * @param lane Lane id of this writer (less than the readers' max_lanes)
+     * @param max_size Maximum size for JSON data in this lane
+     */
+    LaneWriter(const std::string& name, size_t lane, size_t max_size)
+        : lane_(lane)
+        , channel_(laneChannelName(name, lane), max_size, true)
+    {
+    }
+
+    bool write(const json& data) {
+        return channel_.write(data);
+    }
+
+    bool write(const json& data, uint64_t& sequence) {
+        return channel_.write(data, sequence);
+    }
+
+    size_t lane() const {
+        return lane_;
+    }
+
+    SharedMemoryJSON& channel() {
+        return channel_;
+    }
+
+    std::string getLastError() const {
+        return channel_.getLastError();
+    }
+
+private:
+    size_t lane_;
+    SharedMemoryJSON channel_;
+};
+
+/**
+ * One update read from a lane
+ */
+struct LaneUpdate {
+    size_t lane;
+    uint64_t sequence;
+    uint64_t timestamp;     // Write time (microseconds since epoch)
+    json data;
+};
+
+/**
+ * Reader side of a multi-writer channel.
+ *
+ * Attaches to lanes 0..max_lanes-1 as their writers appear and either reads
+ * a single lane, the most recently written lane, or all new updates merged
+ * in timestamp order.
+ */
+class MultiWriterReader {
+public:
+    /**
+     * Constructor
+     * @param name Multi-writer channel name
+     * @param max_lanes Number of lane ids to look for
+     * @param max_size Maximum size for JSON data per lane
+     */
+    MultiWriterReader(const std::string& name, size_t max_lanes, size_t max_size)
+        : name_(name)
+        , max_size_(max_size)
+        , lanes_(max_lanes)
+    {
+        refreshLanes();
+    }
+
+    // Prevent copying
+    MultiWriterReader(const MultiWriterReader&) = delete;
+    MultiWriterReader& operator=(const MultiWriterReader&) = delete;
+
+    /**
+     * Attach to lanes whose writers started, or restarted, since the last call
+     * @return Number of attached lanes
+     *
+     * @note A restarted writer creates a new region for its lane, starting
+     *       over at sequence 1; the lane is reopened and its next data reported.
+     */
+    size_t refreshLanes() {
+        size_t attached = 0;
+        for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+            if (!lanes_[lane]) {
+                try {
+                    lanes_[lane] = std::make_unique<SharedMemoryJSON>(laneChannelName(name_, lane), max_size_, false);
+                    channels_.add(*lanes_[lane]);
+                    lane_of_.push_back(lane);
+                } catch (const std::exception&) {
+                    continue; // Writer for this lane not started yet
+                }
+            } else if (lanes_[lane]->isReplaced()) {
+                reopenLane(lane); // Keeps the old region until the new writer is up
+            }
+            attached++;
+        }
+        last_refresh_ = std::chrono::steady_clock::now();
+        return attached;
+    }
+
+    /**
+     * Whether a lane's writer has been found
+     */
+    bool hasLane(size_t lane) const {
+        return lane < lanes_.size() && lanes_[lane] != nullptr;
+    }
+
+    /**
+     * Read the current data of one lane
+     */
+    bool readLane(size_t lane, json& data, uint64_t& sequence) {
+        if (!hasLane(lane)) {
+            last_error_ = "Lane " + std::to_string(lane) + " is not attached";
+            return false;
+        }
+        if (!lanes_[lane]->read(data, sequence)) {
+            last_error_ = lanes_[lane]->getLastError();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Read the lane that was written most recently
+     * @param update Output parameter for the newest update
+     * @return false if no lane holds data
+     */
+    bool readLatest(LaneUpdate& update) {
+        bool found = false;
+        for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+            LaneUpdate candidate;
+            if (!readInto(lane, candidate)) {
+                continue;
+            }
+            if (!found || candidate.timestamp > update.timestamp) {
+                update = std::move(candidate);
+                found = true;
+            }
+        }
+        if (!found) {
+            last_error_ = "No lane holds data";
+        }
+        return found;
+    }
+
+    /**
+     * Wait for new data on any lane and return every changed lane, oldest write first
+     * @param timeout_ms Timeout in milliseconds
+     * @return Updates merged by write timestamp (empty on timeout)
+     *
+     * @note Lanes are re-scanned for new and restarted writers at most once
+     *       per second, also while waiting.
+     */
+    std::vector<LaneUpdate> waitForUpdates(uint64_t timeout_ms) {
+        auto deadline = detail::deadlineAfter(timeout_ms);
+        std::vector<LaneUpdate> updates;
+        while (true) {
+            if (std::chrono::steady_clock::now() - last_refresh_ >= std::chrono::seconds(1)) {
+                refreshLanes();
+            }
+
+            // Wake for the next refresh, so lanes created while waiting (or while
+            // there are none yet) are picked up
+            auto wake = std::min(deadline, last_refresh_ + std::chrono::seconds(1));
+            auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                wake - std::chrono::steady_clock::now()).count();
+            uint64_t wait_ms = wait_us > 0 ? static_cast<uint64_t>(wait_us + 999) / 1000 : 0;
+
+            for (size_t index : channels_.waitAny(wait_ms)) {
+                LaneUpdate update;
+                if (readInto(lane_of_[index], update)) {
+                    updates.push_back(std::move(update));
+                }
+            }
+            if (!updates.empty() || std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        if (updates.empty()) {
+            last_error_ = "Timeout waiting for new data";
+        }
+        std::sort(updates.begin(), updates.end(), [](const LaneUpdate& a, const LaneUpdate& b) {
+            return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.lane < b.lane;
+        });
+        return updates;
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    std::string name_;
+    size_t max_size_;
+    std::vector<std::unique_ptr<SharedMemoryJSON>> lanes_;
+    ChannelSet channels_;
+    std::vector<size_t> lane_of_;       // Index in channels_ -> lane
+    std::chrono::steady_clock::time_point last_refresh_;
+    std::string last_error_;
+
+    void reopenLane(size_t lane) {
+        std::unique_ptr<SharedMemoryJSON> reopened;
+        try {
+            reopened = std::make_unique<SharedMemoryJSON>(laneChannelName(name_, lane), max_size_, false);
+        } catch (const std::exception&) {
+            return; // Old region unlinked, new one not created yet
+        }
+        size_t index = static_cast<size_t>(std::find(lane_of_.begin(), lane_of_.end(), lane) - lane_of_.begin());
+        channels_.replace(index, *reopened); // Sequence restarts, so report from 0 again
+        lanes_[lane] = std::move(reopened);
+    }
+
+    bool readInto(size_t lane, LaneUpdate& update) {
+        if (!hasLane(lane)) {
+            return false;
+        }
+        update.lane = lane;
+        return lanes_[lane]->read(update.data, update.sequence, update.timestamp);
+    }
+};
+
+} // namespace shared_memory
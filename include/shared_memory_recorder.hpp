@@ -0,0 +1,661 @@
+#pragma once
+
+// Append-only recording of a channel to memory-mapped log files (POSIX only).
+//
+// A recording is a set of files sharing a base path:
+//
+//   <base>.000000.seg   records in sequence order
+//   <base>.000000.idx   one IndexEntry per record of the segment
+//   <base>.000001.seg   next segment, started when the previous one is full
+//   ...
+//
+// A segment is a SegmentHeader followed by records, each a RecordHeader and
+// the serialized JSON payload padded to 8 bytes. used_bytes in the segment
+// header only moves past a record once it is complete, so a recording cut
+// short by a crash is readable up to its last whole record.
+
+#include "shared_memory_json.hpp"
+#include "shared_memory_busy_poll.hpp"
+
+#ifdef _WIN32
+#error "shared_memory_recorder.hpp requires POSIX file mapping"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <dirent.h>
+
+namespace shared_memory {
+
+constexpr uint64_t RECORDING_MAGIC = 0x31304753454D4853ull; // "SHMSEG01"
+constexpr uint32_t RECORDING_VERSION = 1;
+constexpr uint32_t RECORD_MAGIC = 0x43455253;               // "SREC"
+
+struct SegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t segment_index;
+    uint64_t first_sequence;               // Sequence of the first record (0 while empty)
+    uint64_t created_at;                   // Microseconds since epoch
+    std::atomic<uint64_t> record_count;    // Complete records (= valid index entries)
+    std::atomic<uint64_t> used_bytes;      // End of the last complete record
+    uint64_t padding;
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must stay 64 bytes");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;                       // Payload bytes (without padding)
+    uint64_t sequence;
+    uint64_t timestamp;                    // Write time in the channel (microseconds since epoch)
+    uint64_t recorded_at;                  // Time the recorder copied it (microseconds since epoch)
+};
+
+struct IndexEntry {
+    uint64_t sequence;
+    uint64_t timestamp;
+    uint64_t offset;                       // Of the RecordHeader within the segment
+};
+
+/**
+ * One recorded payload (see RecordingReader::next())
+ */
+struct RecordedMessage {
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;
+    uint64_t recorded_at = 0;
+    std::string payload;                   // Serialized JSON as published
+};
+
+struct RecorderOptions {
+    uint64_t segment_bytes = 64ull << 20;  // Size of each segment file
+    size_t max_segments = 0;               // Delete the oldest segments beyond this many (0 = keep all)
+    bool busy_poll = false;                // Spin on the sequence instead of sleeping on the futex
+    int cpu = -1;                          // CPU to pin the recording thread to when busy polling
+    uint64_t wait_timeout_ms = 100;        // Longest sleep between checks for stop()
+};
+
+struct RecorderStats {
+    uint64_t records = 0;                  // Payloads appended
+    uint64_t bytes = 0;                    // Payload bytes appended
+    uint64_t missed = 0;                   // Sequences overwritten before they could be copied
+    uint64_t failed_reads = 0;             // Lock-free copies that failed
+    uint64_t dropped = 0;                  // Payloads copied but not written (log file errors)
+    uint64_t segments = 0;                 // Segments started
+    uint64_t last_sequence = 0;            // Last sequence appended
+};
+
+namespace detail {
+
+inline std::string segmentPath(const std::string& base, uint64_t index, const char* extension) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06llu.%s", static_cast<unsigned long long>(index), extension);
+    return base + suffix;
+}
+
+// Indices of the existing segments of a recording, ascending
+inline std::vector<uint64_t> listSegments(const std::string& base) {
+    std::vector<uint64_t> segments;
+    size_t slash = base.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : base.substr(0, slash));
+    std::string prefix = (slash == std::string::npos ? base : base.substr(slash + 1)) + ".";
+
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return segments;
+    }
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        // <prefix>NNNNNN.seg
+        if (name.size() != prefix.size() + 10 || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - 4, 4, ".seg") != 0) {
+            continue;
+        }
+        std::string digits = name.substr(prefix.size(), 6);
+        if (std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            segments.push_back(std::stoull(digits));
+        }
+    }
+    closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Create (or truncate) a file of the given size and map it read-write
+    bool create(const std::string& path, uint64_t size, std::string& error) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ == -1) {
+            error = "Failed to create " + path + ": " + strerror(errno);
+            return false;
+        }
+        if (ftruncate(fd_, static_cast<off_t>(size)) == -1) {
+            error = "Failed to size " + path + ": " + strerror(errno);
+            close();
+            return false;
+        }
+        return map(path, size, PROT_READ | PROT_WRITE, error);
+    }
+
+    bool openReadOnly(const std::string& path, std::string& error) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ == -1) {
+            error = "Failed to open " + path + ": " + strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) == -1 || st.st_size == 0) {
+            error = "Empty or unreadable file " + path;
+            close();
+            return false;
+        }
+        return map(path, static_cast<uint64_t>(st.st_size), PROT_READ, error);
+    }
+
+    // Unmap and close; a writable file is first truncated to keep_bytes
+    void close(uint64_t keep_bytes = UINT64_MAX) {
+        if (ptr_) {
+            munmap(ptr_, size_);
+            ptr_ = nullptr;
+        }
+        if (fd_ != -1) {
+            if (writable_ && keep_bytes < size_) {
+                if (ftruncate(fd_, static_cast<off_t>(keep_bytes)) == -1) {
+                    // Keeps the sparse tail; readers stop at used_bytes anyway
+                }
+            }
+            ::close(fd_);
+            fd_ = -1;
+        }
+        size_ = 0;
+        writable_ = false;
+    }
+
+    char* data() const { return static_cast<char*>(ptr_); }
+    uint64_t size() const { return size_; }
+    bool isOpen() const { return ptr_ != nullptr; }
+
+private:
+    int fd_ = -1;
+    void* ptr_ = nullptr;
+    uint64_t size_ = 0;
+    bool writable_ = false;
+
+    bool map(const std::string& path, uint64_t size, int protection, std::string& error) {
+        ptr_ = mmap(nullptr, size, protection, MAP_SHARED, fd_, 0);
+        if (ptr_ == MAP_FAILED) {
+            ptr_ = nullptr;
+            error = "Failed to map " + path + ": " + strerror(errno);
+            close();
+            return false;
+        }
+        size_ = size;
+        writable_ = (protection & PROT_WRITE) != 0;
+        return true;
+    }
+};
+
+inline uint64_t recordSpan(uint64_t length) {
+    return sizeof(RecordHeader) + ((length + 7) & ~uint64_t(7));
+}
+
+} // namespace detail
+
+/**
+ * Records every payload published on a channel to a segment-rotated log.
+ *
+ * A background thread follows the channel by sequence number and copies each
+ * new payload with readSerialized(), so the writer is never blocked by the
+ * recorder. Appending is a memcpy into the mapped segment; the only system
+ * calls on the recording path are the wait itself and segment rotation.
+ * A sequence overwritten before the recorder copied it is counted in
+ * RecorderStats::missed; busy polling on a dedicated core keeps that at zero
+ * for all but the fastest writers.
+ */
+class ChannelRecorder {
+public:
+    /**
+     * Constructor - opens the first segment (after any existing ones of the same recording)
+     * @param channel Channel to record (must outlive the recorder)
+     * @param base_path Path prefix of the segment and index files
+     * @param options Segment size, retention and wait strategy
+     * @throws std::runtime_error if the first segment cannot be created
+     */
+    ChannelRecorder(SharedMemoryJSON& channel, const std::string& base_path,
+                    RecorderOptions options = RecorderOptions())
+        : channel_(channel)
+        , base_path_(base_path)
+        , options_(options)
+    {
+        if (options_.segment_bytes < sizeof(SegmentHeader) + detail::recordSpan(0)) {
+            throw std::runtime_error("Segment size too small");
+        }
+        std::vector<uint64_t> existing = detail::listSegments(base_path_);
+        next_segment_ = existing.empty() ? 0 : existing.back() + 1;
+        std::string error;
+        if (!openSegment(options_.segment_bytes, error)) {
+            throw std::runtime_error(error);
+        }
+    }
+
+    ~ChannelRecorder() {
+        stop();
+        closeSegment();
+    }
+
+    // Prevent copying
+    ChannelRecorder(const ChannelRecorder&) = delete;
+    ChannelRecorder& operator=(const ChannelRecorder&) = delete;
+
+    /**
+     * Start recording on a background thread
+     * @param last_seq Sequence number already recorded (0 to include the current data)
+     */
+    void start(uint64_t last_seq = 0) {
+        if (running_) {
+            return;
+        }
+        last_seq_ = last_seq;
+        stopping_ = false;
+        running_ = true;
+        thread_ = std::thread([this]() { recordLoop(); });
+    }
+
+    /**
+     * Stop the background thread; everything recorded so far is in the log
+     */
+    void stop() {
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+        thread_.join();
+        running_ = false;
+    }
+
+    /**
+     * Counters since construction (safe to call while recording)
+     */
+    RecorderStats getStats() const {
+        RecorderStats stats;
+        stats.records = records_.load(std::memory_order_relaxed);
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        stats.missed = missed_.load(std::memory_order_relaxed);
+        stats.failed_reads = failed_reads_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.segments = segments_.load(std::memory_order_relaxed);
+        stats.last_sequence = last_recorded_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * Last log file error (only meaningful when RecorderStats::dropped is non-zero)
+     */
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> guard(error_mutex_);
+        return last_error_;
+    }
+
+private:
+    SharedMemoryJSON& channel_;
+    std::string base_path_;
+    RecorderOptions options_;
+
+    detail::MappedFile segment_;
+    detail::MappedFile index_;
+    uint64_t segment_index_ = 0;
+    uint64_t next_segment_ = 0;
+    uint64_t index_capacity_ = 0;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    bool running_ = false;
+    uint64_t last_seq_ = 0;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> missed_{0};
+    std::atomic<uint64_t> failed_reads_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> segments_{0};
+    std::atomic<uint64_t> last_recorded_{0};
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+
+    SegmentHeader* header() const {
+        return reinterpret_cast<SegmentHeader*>(segment_.data());
+    }
+
+    void recordLoop() {
+        std::unique_ptr<BusyPollReader> poller;
+        if (options_.busy_poll) {
+            BusyPollOptions poll_options;
+            poll_options.cpu = options_.cpu;
+            poller.reset(new BusyPollReader(channel_, poll_options));
+        }
+
+        std::string payload;
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            bool updated = poller ? poller->waitForUpdate(last_seq_, options_.wait_timeout_ms * 1000)
+                                  : channel_.waitForUpdate(last_seq_, options_.wait_timeout_ms);
+            if (!updated) {
+                continue;
+            }
+
+            uint64_t sequence, timestamp;
+            if (!channel_.readSerialized(payload, sequence, timestamp)) {
+                failed_reads_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (sequence <= last_seq_) {
+                continue;
+            }
+            if (last_seq_ != 0 && sequence > last_seq_ + 1) {
+                missed_.fetch_add(sequence - last_seq_ - 1, std::memory_order_relaxed);
+            }
+            last_seq_ = sequence;
+
+            std::string error;
+            if (append(sequence, timestamp, payload, error)) {
+                records_.fetch_add(1, std::memory_order_relaxed);
+                bytes_.fetch_add(payload.size(), std::memory_order_relaxed);
+                last_recorded_.store(sequence, std::memory_order_relaxed);
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> guard(error_mutex_);
+                last_error_ = error;
+            }
+        }
+    }
+
+    bool append(uint64_t sequence, uint64_t timestamp, const std::string& payload, std::string& error) {
+        uint64_t span = detail::recordSpan(payload.size());
+        if (!segment_.isOpen() || header()->used_bytes.load(std::memory_order_relaxed) + span > segment_.size() ||
+            header()->record_count.load(std::memory_order_relaxed) >= index_capacity_) {
+            closeSegment();
+            // A payload larger than a segment gets a segment of its own
+            if (!openSegment(std::max(options_.segment_bytes, sizeof(SegmentHeader) + span), error)) {
+                return false;
+            }
+        }
+
+        SegmentHeader* segment = header();
+        uint64_t offset = segment->used_bytes.load(std::memory_order_relaxed);
+        uint64_t count = segment->record_count.load(std::memory_order_relaxed);
+
+        RecordHeader record;
+        record.magic = RECORD_MAGIC;
+        record.length = static_cast<uint32_t>(payload.size());
+        record.sequence = sequence;
+        record.timestamp = timestamp;
+        record.recorded_at = nowMicros();
+        std::memcpy(segment_.data() + offset, &record, sizeof(record));
+        std::memcpy(segment_.data() + offset + sizeof(record), payload.data(), payload.size());
+
+        IndexEntry entry = {sequence, timestamp, offset};
+        std::memcpy(index_.data() + count * sizeof(IndexEntry), &entry, sizeof(entry));
+
+        if (count == 0) {
+            segment->first_sequence = sequence;
+        }
+        segment->record_count.store(count + 1, std::memory_order_release);
+        segment->used_bytes.store(offset + span, std::memory_order_release);
+        return true;
+    }
+
+    bool openSegment(uint64_t bytes, std::string& error) {
+        uint64_t index = next_segment_;
+        if (!segment_.create(detail::segmentPath(base_path_, index, "seg"), bytes, error)) {
+            return false;
+        }
+        index_capacity_ = (bytes - sizeof(SegmentHeader)) / detail::recordSpan(0);
+        if (!index_.create(detail::segmentPath(base_path_, index, "idx"), index_capacity_ * sizeof(IndexEntry), error)) {
+            segment_.close(0);
+            return false;
+        }
+
+        SegmentHeader* segment = header();
+        segment->magic = RECORDING_MAGIC;
+        segment->version = RECORDING_VERSION;
+        segment->reserved = 0;
+        segment->segment_index = index;
+        segment->first_sequence = 0;
+        segment->created_at = nowMicros();
+        segment->record_count.store(0, std::memory_order_relaxed);
+        segment->used_bytes.store(sizeof(SegmentHeader), std::memory_order_release);
+
+        segment_index_ = index;
+        next_segment_ = index + 1;
+        segments_.fetch_add(1, std::memory_order_relaxed);
+        enforceRetention();
+        return true;
+    }
+
+    // Truncate the finished segment and its index to what was written
+    void closeSegment() {
+        if (!segment_.isOpen()) {
+            return;
+        }
+        uint64_t used = header()->used_bytes.load(std::memory_order_relaxed);
+        uint64_t count = header()->record_count.load(std::memory_order_relaxed);
+        segment_.close(used);
+        index_.close(count * sizeof(IndexEntry));
+    }
+
+    void enforceRetention() {
+        if (options_.max_segments == 0) {
+            return;
+        }
+        std::vector<uint64_t> segments = detail::listSegments(base_path_);
+        for (size_t i = 0; i + options_.max_segments < segments.size(); ++i) {
+            if (segments[i] == segment_index_) {
+                break;
+            }
+            std::remove(detail::segmentPath(base_path_, segments[i], "seg").c_str());
+            std::remove(detail::segmentPath(base_path_, segments[i], "idx").c_str());
+        }
+    }
+
+    static uint64_t nowMicros() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+};
+
+/**
+ * Sequential reader over a recording written by ChannelRecorder.
+ *
+ * Works on a recording that is still being written: at the end of the last
+ * segment next() returns false, and a later call picks up new records and
+ * segments.
+ */
+class RecordingReader {
+public:
+    /**
+     * Constructor
+     * @param base_path Path prefix the recording was written with
+     * @throws std::runtime_error if no segment of the recording exists
+     */
+    explicit RecordingReader(const std::string& base_path)
+        : base_path_(base_path)
+        , segments_(detail::listSegments(base_path))
+    {
+        if (segments_.empty()) {
+            throw std::runtime_error("No recording found at " + base_path);
+        }
+    }
+
+    // Prevent copying
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    /**
+     * Read the next record
+     * @param message Output parameter for the record
+     * @return false at the end of the recording or on a corrupt record (see getLastError())
+     */
+    bool next(RecordedMessage& message) {
+        while (true) {
+            if (!segment_.isOpen() && !openSegment(position_)) {
+                if (!skipDeletedSegment()) {
+                    return false;
+                }
+                continue;
+            }
+            const SegmentHeader* segment = reinterpret_cast<const SegmentHeader*>(segment_.data());
+            uint64_t used = std::min<uint64_t>(segment->used_bytes.load(std::memory_order_acquire), segment_.size());
+
+            if (offset_ + sizeof(RecordHeader) <= used) {
+                RecordHeader record;
+                std::memcpy(&record, segment_.data() + offset_, sizeof(record));
+                if (record.magic != RECORD_MAGIC || offset_ + detail::recordSpan(record.length) > used) {
+                    last_error_ = "Corrupt record in segment " + std::to_string(segments_[position_]);
+                    return false;
+                }
+                message.sequence = record.sequence;
+                message.timestamp = record.timestamp;
+                message.recorded_at = record.recorded_at;
+                message.payload.assign(segment_.data() + offset_ + sizeof(record), record.length);
+                offset_ += detail::recordSpan(record.length);
+                return true;
+            }
+
+            // End of this segment: move on if the recorder has started another one.
+            // Found by number, as retention may have deleted this segment meanwhile.
+            size_t next = segmentAfter(current_segment_);
+            if (next >= segments_.size()) {
+                segments_ = detail::listSegments(base_path_);
+                next = segmentAfter(current_segment_);
+            }
+            if (next >= segments_.size()) {
+                return false;
+            }
+            segment_.close();
+            position_ = next;
+            offset_ = sizeof(SegmentHeader);
+        }
+    }
+
+    /**
+     * Position the reader at the first record with a sequence >= sequence
+     * @return false if the recording has no such record
+     */
+    bool seek(uint64_t sequence) {
+        segments_ = detail::listSegments(base_path_);
+        for (size_t i = 0; i < segments_.size(); ++i) {
+            if (!openSegment(i)) {
+                continue; // Removed by retention meanwhile
+            }
+            const SegmentHeader* segment = reinterpret_cast<const SegmentHeader*>(segment_.data());
+            uint64_t count = segment->record_count.load(std::memory_order_acquire);
+
+            detail::MappedFile index;
+            std::string error;
+            if (count == 0 || !index.openReadOnly(detail::segmentPath(base_path_, segments_[i], "idx"), error)) {
+                continue;
+            }
+            const IndexEntry* entries = reinterpret_cast<const IndexEntry*>(index.data());
+            count = std::min<uint64_t>(count, index.size() / sizeof(IndexEntry));
+            const IndexEntry* found = std::lower_bound(entries, entries + count, sequence,
+                [](const IndexEntry& entry, uint64_t value) { return entry.sequence < value; });
+            if (found != entries + count) {
+                offset_ = found->offset;
+                return true;
+            }
+        }
+        last_error_ = "No record at or after sequence " + std::to_string(sequence);
+        rewind();
+        return false;
+    }
+
+    /**
+     * Go back to the first record of the oldest segment
+     */
+    void rewind() {
+        segment_.close();
+        segments_ = detail::listSegments(base_path_);
+        position_ = 0;
+        offset_ = sizeof(SegmentHeader);
+    }
+
+    /**
+     * Number of segment files in the recording
+     */
+    size_t segmentCount() const {
+        return segments_.size();
+    }
+
+    std::string getLastError() const {
+        return last_error_;
+    }
+
+private:
+    std::string base_path_;
+    std::vector<uint64_t> segments_;
+    size_t position_ = 0;
+    uint64_t current_segment_ = 0;
+    uint64_t offset_ = sizeof(SegmentHeader);
+    detail::MappedFile segment_;
+    std::string last_error_;
+
+    bool openSegment(size_t position) {
+        segment_.close();
+        if (position >= segments_.size()) {
+            last_error_ = "Recording has no segments left";
+            return false;
+        }
+        if (!segment_.openReadOnly(detail::segmentPath(base_path_, segments_[position], "seg"), last_error_)) {
+            return false;
+        }
+        const SegmentHeader* segment = reinterpret_cast<const SegmentHeader*>(segment_.data());
+        if (segment_.size() < sizeof(SegmentHeader) || segment->magic != RECORDING_MAGIC ||
+            segment->version != RECORDING_VERSION) {
+            last_error_ = "Not a recording segment: " + detail::segmentPath(base_path_, segments_[position], "seg");
+            segment_.close();
+            return false;
+        }
+        position_ = position;
+        current_segment_ = segments_[position];
+        offset_ = sizeof(SegmentHeader);
+        last_error_.clear(); // Of a deleted segment skipped on the way here
+        return true;
+    }
+
+    // Retention deleted the segment at position_ before it was opened (e.g. in
+    // a reader built, or rewound, before a rotation): move to the oldest segment
+    // numbered above it
+    bool skipDeletedSegment() {
+        if (position_ >= segments_.size()) {
+            return false;
+        }
+        uint64_t deleted = segments_[position_];
+        struct stat st;
+        if (stat(detail::segmentPath(base_path_, deleted, "seg").c_str(), &st) == 0 || errno != ENOENT) {
+            return false;
+        }
+        segments_ = detail::listSegments(base_path_);
+        position_ = segmentAfter(deleted);
+        offset_ = sizeof(SegmentHeader);
+        return position_ < segments_.size();
+    }
+
+    // Position of the first listed segment numbered above segment
+    size_t segmentAfter(uint64_t segment) const {
+        return static_cast<size_t>(std::upper_bound(segments_.begin(), segments_.end(), segment) - segments_.begin());
+    }
+};
+
+} // namespace shared_memory
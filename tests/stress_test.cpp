@@ -0,0 +1,369 @@
+// Multi-process stress and soak test for SharedMemoryJSON (POSIX only).
+//
+// Forks writer and reader processes that hammer one channel for a fixed
+// duration. Every payload is self-checking: its padding is derived from the
+// writer id and per-writer counter and covered by a checksum, and payload
+// sizes vary so a torn size field is caught as well. The test reports:
+//
+//   torn reads     payload failed to parse or its checksum/padding is wrong
+//   mismatches     the same sequence number returned different payloads
+//   regressions    a reader saw the sequence or a writer's counter go backwards
+//   lost updates   sequence numbers assigned by write() with gaps or duplicates
+//
+// and exits non-zero if any of them occurred.
+
+#include "shared_memory_json.hpp"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+#define GREEN "\033[32m"
+#define RED "\033[31m"
+#define RESET "\033[0m"
+
+namespace {
+
+constexpr size_t MAX_WRITERS = 16;
+constexpr uint64_t SEQUENCE_BITMAP_BITS = uint64_t(1) << 27; // 128M writes, 16 MB
+
+struct Options {
+    std::string channel = "stress_test";
+    unsigned writers = 2;
+    unsigned readers = 4;
+    size_t payload = 4096;
+    double duration_s = 5.0;
+    std::string mode = "both"; // locked | seqlock | both (readers alternate)
+};
+
+struct WriterResult {
+    uint64_t writes;
+    uint64_t failed;
+    uint64_t duplicate_sequences;
+};
+
+struct ReaderResult {
+    bool seqlock;
+    uint64_t reads;
+    uint64_t failed;
+    uint64_t torn;
+    uint64_t mismatches;
+    uint64_t regressions;
+    uint64_t fresh;
+};
+
+struct Control {
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    WriterResult writers[MAX_WRITERS];
+    ReaderResult readers[MAX_READERS];
+    std::atomic<uint64_t> sequences[SEQUENCE_BITMAP_BITS / 64]; // Bit per sequence assigned by write()
+};
+
+uint64_t fnv1a(const std::string& text, uint64_t seed) {
+    uint64_t hash = 1469598103934665603ull ^ seed;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Padding is a pure function of (writer, n), so a payload mixing two writes can't verify
+std::string makePadding(uint64_t writer, uint64_t n, size_t payload) {
+    size_t half = payload / 2;
+    size_t length = half + static_cast<size_t>((n * 7919) % (half + 1));
+    std::string padding(length, ' ');
+    for (size_t i = 0; i < length; ++i) {
+        padding[i] = static_cast<char>('a' + (writer * 31 + n + i) % 26);
+    }
+    return padding;
+}
+
+json makePayload(uint64_t writer, uint64_t n, size_t payload) {
+    std::string padding = makePadding(writer, n, payload);
+    uint64_t checksum = fnv1a(padding, writer * 1000003 + n);
+    return {{"writer", writer}, {"n", n}, {"checksum", checksum}, {"padding", std::move(padding)}};
+}
+
+bool verifyPayload(const json& data, size_t payload) {
+    if (!data.is_object() || !data.contains("writer") || !data.contains("n") ||
+        !data.contains("checksum") || !data.contains("padding")) {
+        return false;
+    }
+    uint64_t writer = data["writer"].get<uint64_t>();
+    uint64_t n = data["n"].get<uint64_t>();
+    const std::string& padding = data["padding"].get_ref<const std::string&>();
+    return data["checksum"].get<uint64_t>() == fnv1a(padding, writer * 1000003 + n) &&
+           padding == makePadding(writer, n, payload);
+}
+
+void waitForStart(Control& control) {
+    control.ready.fetch_add(1);
+    while (!control.start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+int writerProcess(const Options& options, size_t max_size, unsigned id, Control& control) {
+    SharedMemoryJSON channel(options.channel, max_size, false);
+    WriterResult& result = control.writers[id];
+    waitForStart(control);
+
+    for (uint64_t n = 1; !control.stop.load(std::memory_order_relaxed); ++n) {
+        uint64_t sequence = 0;
+        if (!channel.write(makePayload(id, n, options.payload), sequence)) {
+            result.failed++;
+            continue;
+        }
+        result.writes++;
+        if (sequence < SEQUENCE_BITMAP_BITS) {
+            uint64_t bit = uint64_t(1) << (sequence % 64);
+            if (control.sequences[sequence / 64].fetch_or(bit) & bit) {
+                result.duplicate_sequences++;
+            }
+        }
+    }
+    return 0;
+}
+
+int readerProcess(const Options& options, size_t max_size, unsigned id, Control& control) {
+    SharedMemoryJSON channel(options.channel, max_size, false);
+    ReaderResult& result = control.readers[id];
+    result.seqlock = options.mode == "seqlock" || (options.mode == "both" && id % 2 == 1);
+
+    uint64_t last_seq = 0;
+    uint64_t last_writer = 0, last_n = 0;
+    std::vector<uint64_t> last_n_by_writer(MAX_WRITERS, 0);
+    std::string payload;
+    json data;
+    waitForStart(control);
+
+    while (!control.stop.load(std::memory_order_relaxed)) {
+        uint64_t sequence = 0;
+        bool parsed = true;
+        if (result.seqlock) {
+            uint64_t timestamp;
+            if (!channel.readSerialized(payload, sequence, timestamp)) {
+                result.failed++;
+                continue;
+            }
+            try {
+                data = json::parse(payload);
+            } catch (const std::exception&) {
+                parsed = false;
+            }
+        } else if (!channel.read(data, sequence)) {
+            // A torn payload would fail to parse inside read()
+            result.failed++;
+            result.torn += channel.getLastError().find("parse") != std::string::npos ? 1 : 0;
+            continue;
+        }
+        result.reads++;
+
+        if (!parsed || !verifyPayload(data, options.payload)) {
+            result.torn++;
+            continue;
+        }
+
+        uint64_t writer = data["writer"].get<uint64_t>();
+        uint64_t n = data["n"].get<uint64_t>();
+        if (sequence == last_seq) {
+            if (writer != last_writer || n != last_n) {
+                result.mismatches++;
+            }
+            continue;
+        }
+        if (sequence < last_seq || n < last_n_by_writer[writer]) {
+            result.regressions++;
+        }
+        result.fresh++;
+        last_seq = sequence;
+        last_writer = writer;
+        last_n = n;
+        last_n_by_writer[writer] = n;
+    }
+    return 0;
+}
+
+template <typename Body>
+pid_t spawn(Body body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int status = 1;
+        try {
+            status = body();
+        } catch (const std::exception& e) {
+            std::cerr << "child " << getpid() << ": " << e.what() << std::endl;
+        }
+        _exit(status);
+    }
+    return pid;
+}
+
+void report(const std::string& label, uint64_t value, bool must_be_zero) {
+    bool ok = !must_be_zero || value == 0;
+    std::cout << (ok ? GREEN "✓ " : RED "✗ ") << std::left << std::setw(22) << label << RESET << value << std::endl;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [options]\n"
+                      << "  --duration SEC   How long to run (default 5)\n"
+                      << "  --writers N      Writer processes, 1-" << MAX_WRITERS << " (default 2)\n"
+                      << "  --readers N      Reader processes, 1-" << MAX_READERS << " (default 4)\n"
+                      << "  --size BYTES     Maximum padding per payload (default 4096)\n"
+                      << "  --mode MODE      locked, seqlock or both (default both)\n"
+                      << "  --channel NAME   Channel name (default stress_test)" << std::endl;
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--duration") {
+            options.duration_s = std::stod(value);
+        } else if (arg == "--writers") {
+            options.writers = static_cast<unsigned>(std::stoul(value));
+        } else if (arg == "--readers") {
+            options.readers = static_cast<unsigned>(std::stoul(value));
+        } else if (arg == "--size") {
+            options.payload = std::stoul(value);
+        } else if (arg == "--mode") {
+            options.mode = value;
+        } else if (arg == "--channel") {
+            options.channel = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (options.writers < 1 || options.writers > MAX_WRITERS || options.readers < 1 || options.readers > MAX_READERS) {
+        throw std::invalid_argument("Writer or reader count out of range");
+    }
+    if (options.mode != "locked" && options.mode != "seqlock" && options.mode != "both") {
+        throw std::invalid_argument("Unknown mode: " + options.mode);
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseArgs(argc, argv);
+        size_t max_size = options.payload + 256;
+
+        std::cout << "\n========================================" << std::endl;
+        std::cout << "  Shared Memory JSON - Stress Test" << std::endl;
+        std::cout << "========================================" << std::endl;
+        std::cout << options.writers << " writer(s), " << options.readers << " reader(s), mode=" << options.mode
+                  << ", payload<=" << options.payload << " B, " << options.duration_s << " s\n" << std::endl;
+
+        SharedMemoryJSON channel(options.channel, max_size, true);
+        channel.write(makePayload(MAX_WRITERS - 1, 0, options.payload)); // Readers never see an empty channel
+
+        void* memory = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::runtime_error("Failed to map control block");
+        }
+        Control& control = *new (memory) Control();
+        // The priming write above took sequence 1
+        control.sequences[0].fetch_or(2);
+
+        std::vector<pid_t> children;
+        for (unsigned i = 0; i < options.readers; ++i) {
+            children.push_back(spawn([&, i]() { return readerProcess(options, max_size, i, control); }));
+        }
+        for (unsigned i = 0; i < options.writers; ++i) {
+            children.push_back(spawn([&, i]() { return writerProcess(options, max_size, i, control); }));
+        }
+
+        while (control.ready.load() < options.readers + options.writers) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto start = std::chrono::steady_clock::now();
+        control.start.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.duration_s));
+        control.stop.store(true);
+
+        bool children_ok = true;
+        for (pid_t child : children) {
+            int status = 0;
+            waitpid(child, &status, 0);
+            children_ok = children_ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        uint64_t writes = 0, failed_writes = 0, duplicates = 0;
+        for (unsigned i = 0; i < options.writers; ++i) {
+            writes += control.writers[i].writes;
+            failed_writes += control.writers[i].failed;
+            duplicates += control.writers[i].duplicate_sequences;
+        }
+        uint64_t reads = 0, failed_reads = 0, torn = 0, mismatches = 0, regressions = 0, fresh = 0;
+        uint64_t seqlock_reads = 0;
+        for (unsigned i = 0; i < options.readers; ++i) {
+            const ReaderResult& result = control.readers[i];
+            reads += result.reads;
+            failed_reads += result.failed;
+            torn += result.torn;
+            mismatches += result.mismatches;
+            regressions += result.regressions;
+            fresh += result.fresh;
+            seqlock_reads += result.seqlock ? result.reads : 0;
+        }
+
+        // Every sequence from 1 to the last one must have been handed out exactly once
+        uint64_t last_sequence = channel.getSequenceNumber();
+        uint64_t gaps = 0;
+        for (uint64_t seq = 1; seq <= last_sequence && seq < SEQUENCE_BITMAP_BITS; ++seq) {
+            if (!(control.sequences[seq / 64].load() & (uint64_t(1) << (seq % 64)))) {
+                gaps++;
+            }
+        }
+        uint64_t lost = gaps + (last_sequence != writes + 1 ? 1 : 0);
+
+        std::cout << std::fixed << std::setprecision(0);
+        std::cout << "Writes:  " << writes << " (" << writes / seconds << "/s)" << std::endl;
+        std::cout << "Reads:   " << reads << " (" << reads / seconds << "/s, " << seqlock_reads
+                  << " lock-free, " << fresh << " fresh)\n" << std::endl;
+
+        report("Torn reads", torn, true);
+        report("Mismatched payloads", mismatches, true);
+        report("Regressions", regressions, true);
+        report("Lost sequences", lost, true);
+        report("Duplicate sequences", duplicates, true);
+        report("Failed writes", failed_writes, true);
+        report("Failed reads", failed_reads, false);
+
+        ChannelStats stats = channel.getStats();
+        std::cout << "\nLock: " << stats.lock_acquisitions << " acquisitions, " << stats.contended_acquisitions
+                  << " contended, " << stats.lock_wait_ns / 1000000 << " ms blocked" << std::endl;
+
+        bool passed = children_ok && torn == 0 && mismatches == 0 && regressions == 0 && lost == 0 &&
+                      duplicates == 0 && failed_writes == 0 && writes > 0 && reads > 0;
+        std::cout << "\n" << (passed ? GREEN "PASSED" : RED "FAILED") << RESET << std::endl;
+        control.~Control();
+        munmap(memory, sizeof(Control));
+        return passed ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
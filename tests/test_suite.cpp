@@ -1,13 +1,64 @@
+#define SHM_TRACK_ALLOCATIONS
 #include "shared_memory_json.hpp"
+#include "shared_memory_channel_set.hpp"
+#include "shared_memory_dispatcher.hpp"
+#include "shared_memory_coalescing_writer.hpp"
+#include "shared_memory_async_writer.hpp"
+#include "shared_memory_busy_poll.hpp"
+#include "shared_memory_multi_writer.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <cassert>
 #include <vector>
+#include <map>
+#include <set>
+#include <fstream>
+#include <cstdio>
+#include <cstddef>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+#ifndef _WIN32
+#include "shared_memory_inspect.hpp"
+#include "shared_memory_recorder.hpp"
+#include "shared_memory_checkpoint.hpp"
+#include "shared_memory_bridge.hpp"
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Coroutine tests need a C++20 build (CMake and make build the suite that way when they can)
+#if defined(__cpp_impl_coroutine) && defined(__linux__)
+#include "shared_memory_coro.hpp"
+#define SHM_TEST_COROUTINES
+#endif
 
 using json = nlohmann::json;
 using namespace shared_memory;
 
+SHM_DEFINE_ALLOCATION_HOOKS()
+
+#ifdef SHM_TEST_COROUTINES
+// Awaits one update and then one with a timeout, recording what each returned
+coro::Task awaitTwice(coro::AsyncChannel& channel, uint64_t last_seq, std::chrono::milliseconds timeout,
+                      std::vector<coro::ReadResult>& results, std::vector<bool>& timed_out) {
+    results.push_back(co_await channel.next(last_seq));
+    auto maybe = co_await channel.next(results.back().sequence, timeout);
+    timed_out.push_back(!maybe);
+    if (maybe) {
+        results.push_back(*maybe);
+    }
+}
+
+coro::Task awaitOnce(coro::AsyncChannel& channel, uint64_t last_seq, std::chrono::milliseconds timeout,
+                     std::vector<std::optional<coro::ReadResult>>& results) {
+    results.push_back(co_await channel.next(last_seq, timeout));
+}
+#endif
+
 // ANSI color codes for output
 #define GREEN "\033[32m"
 #define RED "\033[31m"
@@ -29,6 +80,26 @@ public:
         test_empty_data();
         test_overwrite();
         test_multiple_readers();
+        test_notify_fd();
+        test_channel_set();
+        test_dispatcher();
+        test_coalescing_writer();
+        test_async_writer();
+        test_busy_poll();
+        test_reader_presence();
+        test_multi_writer();
+        test_lock_free_read();
+        test_snapshot();
+        test_channel_stats();
+        test_lock_profile();
+        test_inspect();
+        test_allocation_stats();
+        test_recorder();
+        test_write_serialized();
+        test_persistent_channel();
+        test_checkpoint();
+        test_bridge();
+        test_coroutines();
         
         std::cout << "\n========================================" << std::endl;
         std::cout << "  Test Summary" << std::endl;
@@ -104,6 +175,7 @@ private:
             assert_true(seq2 > seq1, "Sequence increments on first write");
             assert_true(seq3 > seq2, "Sequence increments on second write");
             assert_true(seq3 == seq2 + 1, "Sequence increments by one");
+            assert_true(reader.peekSequenceNumber() == seq3, "Lock-free sequence load matches");
             
         } catch (const std::exception& e) {
             assert_true(false, std::string("Exception: ") + e.what());
@@ -311,6 +383,1330 @@ private:
             assert_true(false, std::string("Exception: ") + e.what());
         }
     }
+    
+    void test_notify_fd() {
+        std::cout << "\n[Test] Notify FD" << std::endl;
+        
+#ifdef __linux__
+        try {
+            SharedMemoryJSON writer("test_notify", 1024 * 1024, true);
+            SharedMemoryJSON reader("test_notify", 1024 * 1024, false);
+            
+            int fd = reader.getNotifyFd();
+            assert_true(fd >= 0, "Notify fd created");
+            assert_true(reader.getNotifyFd() == fd, "Notify fd is reused");
+            
+            pollfd pfd = {fd, POLLIN, 0};
+            assert_true(poll(&pfd, 1, 0) == 0, "Notify fd idle before write");
+            
+            writer.write({{"value", 1}});
+            assert_true(poll(&pfd, 1, 1000) == 1 && (pfd.revents & POLLIN), "Notify fd readable after write");
+            
+            reader.consumeNotifications();
+            assert_true(poll(&pfd, 1, 0) == 0, "Notify fd re-armed after consume");
+            
+            json data;
+            assert_true(reader.read(data) && data["value"] == 1, "Data readable after notification");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+#else
+        std::cout << YELLOW << "  (skipped: Linux only)" << RESET << std::endl;
+#endif
+    }
+    
+    void test_channel_set() {
+        std::cout << "\n[Test] Channel Set waitAny" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer_a("test_set_a", 1024, true);
+            SharedMemoryJSON writer_b("test_set_b", 1024, true);
+            SharedMemoryJSON writer_c("test_set_c", 1024, true);
+            SharedMemoryJSON reader_a("test_set_a", 1024, false);
+            SharedMemoryJSON reader_b("test_set_b", 1024, false);
+            SharedMemoryJSON reader_c("test_set_c", 1024, false);
+            
+            ChannelSet channels;
+            channels.add(reader_a);
+            channels.add(reader_b);
+            channels.add(reader_c);
+            
+            auto start = std::chrono::steady_clock::now();
+            auto changed = channels.waitAny(300);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            assert_true(changed.empty(), "waitAny times out when nothing is published");
+            assert_true(elapsed >= 250 && elapsed <= 400, "waitAny timeout duration is approximately correct");
+            
+            std::thread writer_thread([&writer_c]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                writer_c.write({{"value", 3}});
+            });
+            
+            start = std::chrono::steady_clock::now();
+            changed = channels.waitAny(2000);
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            writer_thread.join();
+            
+            assert_true(changed.size() == 1 && changed[0] == 2, "waitAny reports the channel that changed");
+            assert_true(elapsed < 500, "waitAny wakes promptly on publish");
+            assert_true(channels.lastSequence(2) == reader_c.getSequenceNumber(), "waitAny records the new sequence");
+            
+            writer_a.write({{"value", 1}});
+            writer_b.write({{"value", 2}});
+            changed = channels.waitAny(0);
+            assert_true(changed.size() == 2 && changed[0] == 0 && changed[1] == 1, "waitAny reports every changed channel");
+            
+            std::thread late_writer([&writer_a]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                writer_a.write({{"value", 4}});
+            });
+            changed = channels.waitAny(UINT64_MAX);
+            late_writer.join();
+            assert_true(changed.size() == 1 && changed[0] == 0, "waitAny accepts an unbounded timeout");
+            assert_true(reader_b.waitForUpdate(0, UINT64_MAX), "waitForUpdate accepts an unbounded timeout");
+            
+            ChannelSet empty;
+            start = std::chrono::steady_clock::now();
+            changed = empty.waitAny(100);
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            assert_true(changed.empty() && elapsed >= 90, "Empty set sleeps for the timeout instead of spinning");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_dispatcher() {
+        std::cout << "\n[Test] Dispatcher" << std::endl;
+        
+        try {
+            std::vector<std::unique_ptr<SharedMemoryJSON>> writers;
+            std::vector<std::unique_ptr<SharedMemoryJSON>> readers;
+            for (int i = 0; i < 4; ++i) {
+                std::string name = "test_dispatch_" + std::to_string(i);
+                writers.push_back(std::make_unique<SharedMemoryJSON>(name, 1024, true));
+                readers.push_back(std::make_unique<SharedMemoryJSON>(name, 1024, false));
+            }
+            
+            std::mutex mutex;
+            std::map<int, std::vector<uint64_t>> sequences;
+            std::map<int, std::set<std::thread::id>> threads;
+            std::map<int, int> latest;
+            
+            Dispatcher dispatcher(2);
+            for (int i = 0; i < 4; ++i) {
+                dispatcher.subscribe(*readers[i], [&, i](const json& data, uint64_t seq) {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    sequences[i].push_back(seq);
+                    threads[i].insert(std::this_thread::get_id());
+                    latest[i] = data["value"];
+                });
+            }
+            dispatcher.start();
+            
+            for (int round = 1; round <= 50; ++round) {
+                for (int i = 0; i < 4; ++i) {
+                    writers[i]->write({{"value", round}});
+                }
+            }
+            
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (std::chrono::steady_clock::now() < deadline) {
+                std::lock_guard<std::mutex> guard(mutex);
+                if (latest.size() == 4 && latest[0] == 50 && latest[1] == 50 && latest[2] == 50 && latest[3] == 50) {
+                    break;
+                }
+            }
+            dispatcher.stop();
+            
+            bool all_latest = true;
+            bool ordered = true;
+            bool single_thread = true;
+            for (int i = 0; i < 4; ++i) {
+                all_latest = all_latest && latest[i] == 50;
+                for (size_t k = 1; k < sequences[i].size(); ++k) {
+                    ordered = ordered && sequences[i][k] > sequences[i][k - 1];
+                }
+                single_thread = single_thread && threads[i].size() == 1;
+            }
+            
+            assert_true(all_latest, "Every channel delivers its latest value");
+            assert_true(ordered, "Per-channel sequences are delivered in order");
+            assert_true(single_thread, "Each channel is handled by a single worker");
+            assert_true(dispatcher.getErrorCount() == 0, "No dispatch errors");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_coalescing_writer() {
+        std::cout << "\n[Test] Coalescing Writer" << std::endl;
+        
+        try {
+            SharedMemoryJSON channel("test_coalesce", 1024, true);
+            SharedMemoryJSON reader("test_coalesce", 1024, false);
+            
+            CoalescingWriter writer(10.0);
+            size_t handle = writer.addChannel(channel);
+            
+            std::vector<std::thread> producers;
+            for (int p = 0; p < 4; ++p) {
+                producers.emplace_back([&writer, handle, p]() {
+                    for (int i = 0; i < 1000; ++i) {
+                        writer.update(handle, {{"producer", p}, {"value", i}});
+                    }
+                });
+            }
+            for (auto& t : producers) {
+                t.join();
+            }
+            writer.update(handle, {{"value", "final"}});
+            
+            assert_true(writer.getPublishedCount(handle) <= 2, "Updates are rate limited");
+            assert_true(writer.getCoalescedCount(handle) >= 3990, "Intermediate updates are coalesced");
+            
+            writer.flush();
+            json data;
+            assert_true(reader.read(data) && data["value"] == "final", "Flush publishes the latest update");
+            
+            uint64_t published = writer.getPublishedCount(handle);
+            writer.flush();
+            assert_true(writer.getPublishedCount(handle) == published, "Flush with nothing pending writes nothing");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_async_writer() {
+        std::cout << "\n[Test] Async Writer" << std::endl;
+        
+        try {
+            SharedMemoryJSON channel("test_async", 1024, true);
+            SharedMemoryJSON reader("test_async", 1024, false);
+            
+            std::vector<std::future<uint64_t>> futures;
+            {
+                AsyncWriter writer(channel);
+                for (int i = 1; i <= 100; ++i) {
+                    futures.push_back(writer.writeAsync({{"value", i}}));
+                }
+                
+                futures.back().wait();
+                json data;
+                uint64_t read_seq = 0;
+                assert_true(reader.read(data, read_seq) && data["value"] == 100 && read_seq == 100,
+                            "Last queued document is readable at its assigned sequence");
+                
+                auto failed = writer.writeAsync({{"blob", std::string(2048, 'x')}});
+                bool threw = false;
+                try {
+                    failed.get();
+                } catch (const std::runtime_error&) {
+                    threw = true;
+                }
+                assert_true(threw, "Failed write surfaces as an exception in the future");
+            }
+            
+            bool sequential = true;
+            for (size_t i = 0; i < futures.size(); ++i) {
+                sequential = sequential && futures[i].get() == i + 1;
+            }
+            assert_true(sequential, "Documents are written in order with consecutive sequences");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_busy_poll() {
+        std::cout << "\n[Test] Busy-Poll Reader" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_busy", 1024, true);
+            SharedMemoryJSON channel("test_busy", 1024, false);
+            
+            BusyPollOptions options;
+            options.cpu = 0;
+            BusyPollReader reader(channel, options);
+            
+            // Spin on a separate thread so pinning doesn't leak into later tests
+            bool timed_out = false;
+            bool result = false;
+            json data;
+            uint64_t seq = 0;
+            std::thread reader_thread([&]() {
+                timed_out = !reader.waitForUpdate(0, 2000);
+                result = reader.read(data, seq, 0, 1000000);
+            });
+            
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            writer.write({{"value", 7}});
+            reader_thread.join();
+            
+            assert_true(timed_out, "Spin wait times out without data");
+            assert_true(result && data["value"] == 7 && seq == 1, "Spin read returns new data");
+
+            std::thread spinner([&]() { reader.waitForUpdate(seq, 400000); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            bool active = writer.getActiveReaderCount(150) == 1;
+            spinner.join();
+            assert_true(active, "A spinning reader keeps its heartbeat fresh");
+#ifdef __linux__
+            assert_true(reader.isPinned(), "Polling thread pinned to CPU 0");
+#endif
+            
+            const SpinStats& stats = reader.getStats();
+            assert_true(stats.waits == 3 && stats.updates == 1 && stats.timeouts == 2, "Spin stats count waits");
+            assert_true(stats.polls > 1 && stats.efficiency() > 0.0, "Spin stats count polls");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_reader_presence() {
+        std::cout << "\n[Test] Reader Presence" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_presence", 1024, true);
+            assert_true(!writer.hasActiveReaders(), "No readers before any attach");
+            
+            {
+                SharedMemoryJSON reader_a("test_presence", 1024, false);
+                SharedMemoryJSON reader_b("test_presence", 1024, false);
+                assert_true(writer.hasActiveReaders(), "Attached reader is reported");
+                assert_true(writer.getActiveReaderCount() == 2, "Each reader is counted");
+                
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                writer.write({{"value", 1}});
+                json data;
+                reader_a.read(data);
+                assert_true(writer.getActiveReaderCount(10) == 1, "Idle readers are excluded by max_idle_ms");
+            }
+            assert_true(!writer.hasActiveReaders(), "Readers unregister on destruction");
+            
+#ifndef _WIN32
+            pid_t child = fork();
+            if (child == 0) {
+                SharedMemoryJSON reader("test_presence", 1024, false);
+                _exit(0); // Exit without running the destructor
+            }
+            waitpid(child, nullptr, 0);
+            assert_true(writer.getActiveReaderCount(1000000) == 0, "Slots of dead reader processes are released");
+#endif
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_multi_writer() {
+        std::cout << "\n[Test] Multi-Writer Lanes" << std::endl;
+        
+        try {
+            LaneWriter primary("test_lanes", 0, 1024);
+            MultiWriterReader reader("test_lanes", 4, 1024);
+            assert_true(reader.hasLane(0) && !reader.hasLane(1), "Reader attaches to existing lanes only");
+            
+            LaneWriter backup("test_lanes", 1, 1024);
+            assert_true(reader.refreshLanes() == 2, "Reader attaches to lanes that start later");
+            
+            std::thread first([&primary]() {
+                for (int i = 1; i <= 100; ++i) {
+                    primary.write({{"from", "primary"}, {"i", i}});
+                }
+            });
+            std::thread second([&backup]() {
+                for (int i = 1; i <= 100; ++i) {
+                    backup.write({{"from", "backup"}, {"i", i}});
+                }
+            });
+            first.join();
+            second.join();
+            
+            json data;
+            uint64_t seq0 = 0, seq1 = 0;
+            reader.readLane(0, data, seq0);
+            reader.readLane(1, data, seq1);
+            assert_true(seq0 == 100 && seq1 == 100, "Each lane keeps its own sequence");
+            
+            reader.waitForUpdates(0); // Consume the bulk writes
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            backup.write({{"from", "backup"}, {"i", 101}});
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            primary.write({{"from", "primary"}, {"i", 101}});
+            
+            LaneUpdate latest;
+            assert_true(reader.readLatest(latest) && latest.lane == 0, "readLatest picks the newest write");
+            
+            auto updates = reader.waitForUpdates(1000);
+            assert_true(updates.size() == 2 && updates[0].lane == 1 && updates[1].lane == 0,
+                        "waitForUpdates merges lanes by timestamp");
+
+            auto restarting = std::make_unique<LaneWriter>("test_lanes", 2, 1024);
+            for (int i = 1; i <= 50; ++i) {
+                restarting->write({{"run", 1}, {"i", i}});
+            }
+            reader.refreshLanes();
+            reader.waitForUpdates(0);
+            restarting.reset();
+            restarting = std::make_unique<LaneWriter>("test_lanes", 2, 1024);
+            restarting->write({{"run", 2}, {"i", 1}});
+            reader.refreshLanes();
+            updates = reader.waitForUpdates(1000);
+            assert_true(updates.size() == 1 && updates[0].lane == 2 && updates[0].sequence == 1 &&
+                        updates[0].data["run"] == 2, "Reader follows a restarted lane writer");
+
+            auto start = std::chrono::steady_clock::now();
+            updates = reader.waitForUpdates(1500);
+            auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            assert_true(updates.empty() && waited >= 1400, "waitForUpdates waits out the full timeout");
+
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_lock_free_read() {
+        std::cout << "\n[Test] Lock-Free Read" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_seqlock", 64 * 1024, true);
+            SharedMemoryJSON reader("test_seqlock", 64 * 1024, false);
+            
+            std::string payload;
+            uint64_t seq = 0, timestamp = 0;
+            assert_true(!reader.readSerialized(payload, seq, timestamp), "Lock-free read fails before any write");
+            
+            writer.write({{"value", 5}});
+            assert_true(reader.readSerialized(payload, seq, timestamp) && seq == 1 && timestamp > 0,
+                        "Lock-free read returns sequence and timestamp");
+            assert_true(json::parse(payload)["value"] == 5, "Lock-free read returns the payload");
+            
+            std::atomic<bool> running{true};
+            std::thread writer_thread([&]() {
+                for (int i = 0; running; ++i) {
+                    writer.write({{"a", i}, {"pad", std::string(i % 4096, 'x')}, {"b", i}});
+                }
+            });
+            
+            bool consistent = true;
+            for (int i = 0; i < 2000 && consistent; ++i) {
+                if (reader.readSerialized(payload, seq, timestamp)) {
+                    json data = json::parse(payload, nullptr, false);
+                    consistent = !data.is_discarded() && (!data.contains("a") || data["a"] == data["b"]);
+                }
+            }
+            running = false;
+            writer_thread.join();
+            
+            assert_true(consistent, "Lock-free reads are never torn under concurrent writes");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_snapshot() {
+        std::cout << "\n[Test] Consistent Snapshot" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer_a("test_snap_a", 64 * 1024, true);
+            SharedMemoryJSON writer_b("test_snap_b", 64 * 1024, true);
+            SharedMemoryJSON writer_c("test_snap_c", 64 * 1024, true);
+            SharedMemoryJSON reader_a("test_snap_a", 64 * 1024, false);
+            SharedMemoryJSON reader_b("test_snap_b", 64 * 1024, false);
+            SharedMemoryJSON reader_c("test_snap_c", 64 * 1024, false);
+            
+            writer_a.write({{"name", "a"}});
+            writer_b.write({{"name", "b"}});
+            
+            ChannelSet channels;
+            channels.add(reader_a);
+            channels.add(reader_b);
+            channels.add(reader_c);
+            
+            Snapshot snapshot = channels.snapshot();
+            assert_true(snapshot.channels.size() == 3, "Snapshot covers every channel");
+            assert_true(snapshot.channels[0].valid && snapshot.channels[0].data["name"] == "a" &&
+                        snapshot.channels[1].valid && snapshot.channels[1].data["name"] == "b",
+                        "Snapshot returns each channel's data");
+            assert_true(!snapshot.channels[2].valid && !snapshot.channels[2].error.empty(),
+                        "Uninitialized channel is reported invalid");
+            
+            std::atomic<bool> running{true};
+            std::thread writer_thread([&]() {
+                for (int i = 0; running; ++i) {
+                    writer_a.write({{"a", i}, {"pad", std::string(i % 8192, 'x')}, {"b", i}});
+                }
+            });
+            
+            bool consistent = true;
+            for (int i = 0; i < 500 && consistent; ++i) {
+                Snapshot busy = channels.snapshot();
+                const ChannelSnapshot& entry = busy.channels[0];
+                if (entry.valid && entry.data.contains("a")) {
+                    consistent = entry.data["a"] == entry.data["b"];
+                }
+                consistent = consistent && busy.channels[1].valid;
+            }
+            running = false;
+            writer_thread.join();
+            
+            assert_true(consistent, "Snapshots stay consistent under concurrent writes");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_channel_stats() {
+        std::cout << "\n[Test] Channel Statistics" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_stats", 4096, true);
+            SharedMemoryJSON reader("test_stats", 4096, false);
+            
+            json data;
+            reader.read(data); // No data yet
+            
+            json doc = {{"value", 42}};
+            for (int i = 0; i < 3; ++i) {
+                writer.write(doc);
+            }
+            reader.read(data);
+            reader.read(data);
+            std::string payload;
+            uint64_t seq, ts;
+            reader.readSerialized(payload, seq, ts);
+            
+            ChannelStats stats = writer.getStats();
+            assert_true(stats.writes == 3, "Writes are counted");
+            assert_true(stats.bytes_written == 3 * doc.dump().size(), "Written bytes are counted");
+            assert_true(stats.reads == 3 && stats.failed_reads == 1, "Reads and failed reads are counted");
+            assert_true(stats.lock_acquisitions == 6, "Lock acquisitions are counted (lock-free reads excluded)");
+            
+            ChannelStats seen_by_reader = reader.getStats();
+            assert_true(seen_by_reader.writes == stats.writes && seen_by_reader.reads == stats.reads,
+                        "Counters are shared by every process on the channel");
+            
+            std::thread other([&reader]() {
+                json value;
+                for (int i = 0; i < 200; ++i) {
+                    reader.read(value);
+                }
+            });
+            for (int i = 0; i < 200; ++i) {
+                writer.write({{"pad", std::string(2048, 'x')}});
+            }
+            other.join();
+            
+            stats = writer.getStats();
+            assert_true(stats.lock_acquisitions == 6 + 400, "Concurrent acquisitions are all counted");
+            assert_true(stats.contended_acquisitions <= stats.lock_acquisitions &&
+                        (stats.contended_acquisitions == 0) == (stats.lock_wait_ns == 0),
+                        "Wait time is only accumulated for contended acquisitions");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_lock_profile() {
+        std::cout << "\n[Test] Lock Profiling" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_lock_profile", 64 * 1024, true);
+            SharedMemoryJSON reader("test_lock_profile", 64 * 1024, false);
+            
+            json data;
+            writer.write({{"value", 1}});
+            reader.read(data);
+            LockProfile profile = reader.getLockProfile();
+            assert_true(!profile.enabled && profile.write.count == 0 && profile.read.count == 0,
+                        "Nothing is recorded while profiling is disabled");
+            
+            reader.enableLockProfiling(true);
+            assert_true(writer.getLockProfile().enabled, "Profiling flag is shared by all processes");
+            
+            json big = {{"pad", std::string(32 * 1024, 'x')}};
+            for (int i = 0; i < 10; ++i) {
+                writer.write(big);
+            }
+            for (int i = 0; i < 5; ++i) {
+                reader.read(data);
+            }
+            reader.getSequenceNumber();
+            
+            profile = writer.getLockProfile();
+            assert_true(profile.write.count == 10 && profile.read.count == 5 && profile.query.count == 1,
+                        "Acquisitions are attributed to their operation type");
+            
+            uint64_t wait_total = 0, hold_total = 0;
+            for (size_t i = 0; i < LOCK_HISTOGRAM_BUCKETS; ++i) {
+                wait_total += profile.read.wait_histogram[i];
+                hold_total += profile.read.hold_histogram[i];
+            }
+            assert_true(wait_total == 5 && hold_total == 5, "Every acquisition lands in both histograms");
+            assert_true(profile.read.total_hold_ns > 0 && profile.read.max_hold_ns > 0 &&
+                        profile.read.holdPercentile(99) >= profile.read.holdPercentile(50),
+                        "Hold times and percentiles are recorded");
+#ifndef _WIN32
+            assert_true(profile.read.max_hold_pid == static_cast<uint32_t>(getpid()),
+                        "Longest hold is attributed to its process");
+#endif
+            
+            writer.enableLockProfiling(false);
+            writer.write(big);
+            assert_true(writer.getLockProfile().write.count == 10, "Disabling stops recording");
+            
+            writer.resetLockProfile();
+            profile = writer.getLockProfile();
+            assert_true(profile.write.count == 0 && profile.read.max_hold_ns == 0, "Profile can be reset");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_inspect() {
+        std::cout << "\n[Test] Read-Only Inspection" << std::endl;
+        
+#ifndef _WIN32
+        try {
+            SharedMemoryJSON writer("test_inspect", 2048, true);
+            ChannelInfo info;
+            std::string error;
+            assert_true(!inspectChannel("test_inspect", info, error) && !error.empty(),
+                        "Channel without a first write is not recognized");
+            
+            SharedMemoryJSON reader("test_inspect", 2048, false);
+            json doc = {{"value", 7}};
+            writer.write(doc);
+            writer.write(doc);
+            json data;
+            reader.read(data);
+            
+            assert_true(inspectChannel("test_inspect", info, error), "Written channel is inspected");
+            assert_true(info.compatible && info.version == PROTOCOL_VERSION, "Protocol version is reported");
+            assert_true(info.sequence == 2 && info.data_size == doc.dump().size() && info.max_data_size == 2048,
+                        "Header fields are reported");
+            assert_true(info.readers == 1, "Attached readers are counted");
+            assert_true(info.stats.writes == 2 && info.stats.reads == 1, "Stats counters are reported");
+            
+            uint64_t acquisitions = writer.getStats().lock_acquisitions;
+            inspectChannel("test_inspect", info, error);
+            assert_true(writer.getStats().lock_acquisitions == acquisitions, "Inspection never takes the lock");
+            
+#ifdef __linux__
+            bool listed = false;
+            for (const ChannelInfo& channel : listChannels()) {
+                listed = listed || channel.name == "test_inspect";
+            }
+            assert_true(listed, "listChannels() finds the channel in /dev/shm");
+#endif
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+#endif
+    }
+    
+    void test_allocation_stats() {
+        std::cout << "\n[Test] Allocation Statistics" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_alloc", 4096, true);
+            SharedMemoryJSON reader("test_alloc", 4096, false);
+            assert_true(ALLOCATION_TRACKING, "Test suite is built with allocation tracking");
+            
+            json doc = {{"items", {1, 2, 3, 4, 5}}, {"name", std::string(100, 'x')}};
+            writer.write(doc);
+            writer.write(doc);
+            AllocationStats written = writer.getAllocationStats();
+            assert_true(written.writes == 2 && written.write_allocations >= 2, "write() allocations are counted");
+            assert_true(written.write_bytes >= 2 * doc.dump().size(), "write() allocated bytes cover the serialized text");
+            
+            json data;
+            reader.read(data);
+            AllocationStats read = reader.getAllocationStats();
+            assert_true(read.reads == 1 && read.read_allocations > 5, "read() counts the parsed nodes");
+            assert_true(reader.getAllocationStats().writes == 0, "Counters are per instance");
+            
+            // Allocations on other threads are not attributed to the call
+            std::thread noise([]() {
+                for (int i = 0; i < 1000; ++i) {
+                    std::vector<int> garbage(16);
+                }
+            });
+            std::string payload;
+            uint64_t seq, ts;
+            reader.resetAllocationStats();
+            reader.readSerialized(payload, seq, ts);
+            reader.readSerialized(payload, seq, ts);
+            noise.join();
+            AllocationStats serialized = reader.getAllocationStats();
+            assert_true(serialized.reads == 2 && serialized.read_allocations <= 1,
+                        "readSerialized() reuses the caller's buffer");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_recorder() {
+        std::cout << "\n[Test] Channel Recorder" << std::endl;
+#ifndef _WIN32
+        char directory[] = "/tmp/shm_recorder_XXXXXX";
+        if (!mkdtemp(directory)) {
+            assert_true(false, "Create temporary directory");
+            return;
+        }
+        std::string base = std::string(directory) + "/rec";
+        
+        try {
+            SharedMemoryJSON writer("test_recorder", 4096, true);
+            SharedMemoryJSON reader("test_recorder", 4096, false);
+            
+            RecorderOptions options;
+            options.segment_bytes = 1024; // A handful of records per segment
+            options.wait_timeout_ms = 10;
+            {
+                ChannelRecorder recorder(reader, base, options);
+                recorder.start();
+                for (int i = 1; i <= 30; ++i) {
+                    writer.write({{"i", i}, {"pad", std::string(static_cast<size_t>(i), 'x')}});
+                    // Follow writes one at a time so no sequence is overwritten before it is copied
+                    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+                    while (recorder.getStats().last_sequence < static_cast<uint64_t>(i) &&
+                           std::chrono::steady_clock::now() < deadline) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                }
+                recorder.stop();
+                
+                RecorderStats stats = recorder.getStats();
+                assert_true(stats.records == 30 && stats.missed == 0 && stats.last_sequence == 30,
+                            "Every sequence is recorded");
+                assert_true(stats.segments > 1, "Segments rotate when full");
+            }
+            
+            RecordingReader recording(base);
+            RecordedMessage message;
+            bool in_order = true;
+            int count = 0;
+            while (recording.next(message)) {
+                count++;
+                json data = json::parse(message.payload);
+                in_order = in_order && message.sequence == static_cast<uint64_t>(count) && data["i"] == count;
+            }
+            assert_true(count == 30 && in_order, "Recording replays every payload in order");
+            assert_true(recording.getLastError().empty(), "Recording ends cleanly");
+            
+            assert_true(recording.seek(17) && recording.next(message) && message.sequence == 17,
+                        "seek() finds a record through the index");
+            assert_true(!recording.seek(31), "seek() past the end fails");
+            
+            // A second recorder appends new segments after the existing ones and applies retention
+            size_t segments_before = recording.segmentCount();
+            options.max_segments = 2;
+            {
+                ChannelRecorder recorder(reader, base, options);
+                recorder.start(writer.getSequenceNumber() - 1);
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+                while (recorder.getStats().records == 0 && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            RecordingReader trimmed(base);
+            assert_true(segments_before > 2 && trimmed.segmentCount() == 2, "Old segments beyond max_segments are deleted");
+            assert_true(trimmed.next(message), "Trimmed recording is still readable");
+            
+            // Retention deleting the segment a reader is in must not make it lose its place.
+            // Two copies of the newest segment stand in for segments the recorder adds
+            // while every older one is deleted.
+            RecordingReader follower(base);
+            while (follower.next(message)) {
+            }
+            RecordingReader unopened(base);
+            RecordingReader rewound(base);
+            while (rewound.next(message)) {
+            }
+            rewound.rewind();
+            std::vector<uint64_t> segments = detail::listSegments(base);
+            for (uint64_t copy = 1; copy <= 2; ++copy) {
+                for (const char* extension : {"seg", "idx"}) {
+                    std::ifstream in(detail::segmentPath(base, segments.back(), extension), std::ios::binary);
+                    std::ofstream out(detail::segmentPath(base, segments.back() + copy, extension), std::ios::binary);
+                    out << in.rdbuf();
+                }
+            }
+            for (uint64_t segment : segments) {
+                std::remove(detail::segmentPath(base, segment, "seg").c_str());
+                std::remove(detail::segmentPath(base, segment, "idx").c_str());
+            }
+            size_t expected = 0;
+            RecordingReader replacement(base);
+            while (replacement.next(message)) {
+                expected++;
+            }
+            size_t resumed = 0;
+            while (follower.next(message)) {
+                resumed++;
+            }
+            assert_true(expected > 0 && resumed == expected, "Reader resumes after its deleted segment");
+            size_t from_oldest = 0;
+            while (unopened.next(message)) {
+                from_oldest++;
+            }
+            assert_true(from_oldest == expected, "Reader skips segments deleted before it opened them");
+            from_oldest = 0;
+            while (rewound.next(message)) {
+                from_oldest++;
+            }
+            assert_true(from_oldest == expected, "Rewound reader skips deleted segments");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+        
+        for (uint64_t segment : detail::listSegments(base)) {
+            std::remove(detail::segmentPath(base, segment, "seg").c_str());
+            std::remove(detail::segmentPath(base, segment, "idx").c_str());
+        }
+        rmdir(directory);
+#endif
+    }
+    
+    void test_write_serialized() {
+        std::cout << "\n[Test] Write Serialized" << std::endl;
+        
+        try {
+            SharedMemoryJSON writer("test_write_serialized", 64, true);
+            SharedMemoryJSON reader("test_write_serialized", 64, false);
+            
+            std::string payload = "{\"b\": 2,  \"a\": [1, 2]}";
+            uint64_t sequence = 0;
+            assert_true(writer.writeSerialized(payload, sequence) && sequence == 1, "writeSerialized() assigns a sequence");
+            
+            std::string copy;
+            uint64_t seq, ts;
+            assert_true(reader.readSerialized(copy, seq, ts) && copy == payload, "Payload is published verbatim");
+            json data;
+            assert_true(reader.read(data) && data["a"][1] == 2, "Readers parse it like any write");
+            
+            assert_true(!writer.writeSerialized(std::string(65, ' ')), "Oversized payload is rejected");
+            assert_true(writer.getSequenceNumber() == 1, "Rejected payload is not published");
+            assert_true(writer.getStats().bytes_written == payload.size(), "Published bytes are counted");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+    }
+    
+    void test_persistent_channel() {
+        std::cout << "\n[Test] Persistent Channel" << std::endl;
+#ifndef _WIN32
+        char directory[] = "/tmp/shm_persistent_XXXXXX";
+        if (!mkdtemp(directory)) {
+            assert_true(false, "Create temporary directory");
+            return;
+        }
+        const std::string path = std::string(directory) + "/status.shm";
+        ChannelOptions options;
+        options.backing_path = path;
+        
+        try {
+            {
+                SharedMemoryJSON writer("test_persistent", 256, true, options);
+                assert_true(!writer.wasRestored(), "New backing file starts empty");
+                writer.write({{"v", 1}});
+                writer.write({{"v", 2}});
+                assert_true(writer.sync(), "sync() flushes the file");
+            }
+            
+            ChannelInfo info;
+            std::string error;
+            assert_true(inspectChannelFile(path, info, error) && info.sequence == 2 && info.max_data_size == 256,
+                        "Backing file is inspected by path");
+            assert_true(inspectChannel("status.shm", info, error, directory) && info.sequence == 2,
+                        "Backing file is inspected by directory");
+            std::vector<ChannelInfo> listed = listChannels(directory);
+            assert_true(listed.size() == 1 && listed[0].name == "status.shm", "listChannels() scans other directories");
+            
+            {
+                SharedMemoryJSON writer("test_persistent", 256, true, options);
+                SharedMemoryJSON reader("test_persistent", 256, false, options);
+                assert_true(writer.wasRestored(), "Restarted creator keeps the data");
+                assert_true(writer.getSequenceNumber() == 2, "Sequence number survives the restart");
+                json data;
+                assert_true(reader.read(data) && data["v"] == 2, "Last payload survives the restart");
+                uint64_t sequence = 0;
+                writer.write({{"v", 3}}, sequence);
+                assert_true(sequence == 3, "Sequence numbers continue after the restart");
+                
+                // A shared memory channel of the same name has a lock of its own
+                {
+                    SharedMemoryJSON other("test_persistent", 256, true);
+                    other.write({{"other", true}});
+                }
+                assert_true(reader.read(data) && data["v"] == 3, "Same-named shm channel leaves the file untouched");
+                bool attached = false;
+                try {
+                    SharedMemoryJSON late_reader("test_persistent", 256, false, options);
+                    attached = true;
+                } catch (const std::exception&) {
+                }
+                assert_true(attached, "Same-named shm channel does not unlink the file-backed lock");
+            }
+            
+            // Reader slots persisted from before a reboot hold pids that may be reused
+            if (FILE* file = std::fopen(path.c_str(), "r+b")) {
+                uint32_t pid = 1; // Alive, but not a reader
+                uint64_t heartbeat = 1;
+                std::fseek(file, offsetof(SharedMemoryHeader, readers), SEEK_SET);
+                std::fwrite(&pid, sizeof(pid), 1, file);
+                std::fseek(file, offsetof(SharedMemoryHeader, readers) + offsetof(ReaderSlot, heartbeat), SEEK_SET);
+                std::fwrite(&heartbeat, sizeof(heartbeat), 1, file);
+                std::fclose(file);
+            }
+            {
+                SharedMemoryJSON writer("test_persistent", 256, true, options);
+                assert_true(writer.wasRestored() && writer.getActiveReaderCount() == 0,
+                            "Reader slots from before the boot are dropped");
+            }
+            
+            // Simulate a writer that crashed mid-write
+            if (FILE* file = std::fopen(path.c_str(), "r+b")) {
+                uint64_t odd = 7;
+                std::fseek(file, offsetof(SharedMemoryHeader, write_counter), SEEK_SET);
+                std::fwrite(&odd, sizeof(odd), 1, file);
+                std::fclose(file);
+            }
+            {
+                SharedMemoryJSON writer("test_persistent", 256, true, options);
+                json data;
+                assert_true(!writer.wasRestored(), "Torn write is not restored");
+                assert_true(!writer.read(data), "Torn payload is discarded");
+                assert_true(writer.getSequenceNumber() == 3, "Sequence number survives a torn write");
+                uint64_t sequence = 0;
+                assert_true(writer.write({{"v", 4}}, sequence) && sequence == 4, "Channel is writable after a torn write");
+            }
+
+#ifdef __linux__
+            // A writer that died holding the lock before it stored its pid: take
+            // the channel's semaphore (found among this process's mappings) directly
+            {
+                SharedMemoryJSON reader("test_persistent", 256, false, options);
+                std::string sem_name;
+                std::ifstream maps("/proc/self/maps");
+                for (std::string line; std::getline(maps, line) && sem_name.empty();) {
+                    size_t found = line.find("/dev/shm/sem.sem_test_persistent.f");
+                    if (found != std::string::npos) {
+                        sem_name = "/" + line.substr(found + std::strlen("/dev/shm/sem."));
+                    }
+                }
+                sem_t* sem = sem_name.empty() ? SEM_FAILED : sem_open(sem_name.c_str(), 0);
+                assert_true(sem != SEM_FAILED && sem_wait(sem) == 0, "Take the channel lock without an owner");
+                if (sem != SEM_FAILED) {
+                    sem_close(sem);
+                    SharedMemoryJSON writer("test_persistent", 256, true, options);
+                    assert_true(writer.write({{"v", 5}}), "Lock held without an owner is recovered");
+                }
+            }
+#endif
+
+            {
+                SharedMemoryJSON writer("test_persistent", 512, true, options);
+                assert_true(!writer.wasRestored() && writer.getSequenceNumber() == 0,
+                            "Different size resets the channel");
+            }
+            assert_true(std::ifstream(path).good(), "Backing file outlives the creator");
+            
+            bool threw = false;
+            try {
+                ChannelOptions missing;
+                missing.backing_path = std::string(directory) + "/missing.shm";
+                SharedMemoryJSON reader("test_persistent_missing", 256, false, missing);
+            } catch (const std::exception&) {
+                threw = true;
+            }
+            assert_true(threw, "Opening a missing backing file throws");
+            
+            assert_true(SharedMemoryJSON::removeBackingLock("test_persistent", path), "Remove the channel lock");
+            threw = false;
+            try {
+                SharedMemoryJSON reader("test_persistent", 512, false, options);
+            } catch (const std::exception&) {
+                threw = true;
+            }
+            assert_true(threw, "Readers cannot attach once the lock is removed");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+        SharedMemoryJSON::removeBackingLock("test_persistent", path);
+        std::remove(path.c_str());
+        rmdir(directory);
+#endif
+    }
+    
+    void test_checkpoint() {
+        std::cout << "\n[Test] Checkpoint" << std::endl;
+#ifndef _WIN32
+        char directory[] = "/tmp/shm_checkpoint_XXXXXX";
+        if (!mkdtemp(directory)) {
+            assert_true(false, "Create temporary directory");
+            return;
+        }
+        std::string path = std::string(directory) + "/status.ckp";
+        
+        try {
+            SharedMemoryJSON writer("test_checkpoint", 256, true);
+            SharedMemoryJSON snapshot_reader("test_checkpoint", 256, false);
+            CheckpointOptions options;
+            options.interval_ms = 10;
+            options.sync = false;
+            ChannelCheckpointer checkpointer(snapshot_reader, path, options);
+            
+            assert_true(checkpointer.checkpointNow() && checkpointer.getStats().checkpoints == 0,
+                        "Empty channel is not checkpointed");
+            writer.write({{"v", 1}});
+            writer.write({{"v", 2}});
+            assert_true(checkpointer.checkpointNow() && checkpointer.getStats().last_sequence == 2,
+                        "checkpointNow() saves the current payload");
+            assert_true(checkpointer.checkpointNow() && checkpointer.getStats().unchanged == 1,
+                        "Unchanged channel is skipped");
+            
+            Checkpoint checkpoint;
+            std::string error;
+            assert_true(readCheckpoint(path, checkpoint, error) && checkpoint.sequence == 2 &&
+                        json::parse(checkpoint.payload)["v"] == 2, "Checkpoint file holds the payload");
+            
+            checkpointer.start();
+            writer.write({{"v", 3}});
+            for (int i = 0; i < 200 && checkpointer.getStats().last_sequence != 3; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            writer.write({{"v", 4}});
+            checkpointer.stop();
+            assert_true(checkpointer.getStats().last_sequence == 4, "Background thread checkpoints until stop()");
+            assert_true(checkpointer.getStats().failed == 0, "No checkpoint failed");
+            
+            {
+                SharedMemoryJSON restored("test_checkpoint_restored", 256, true);
+                uint64_t sequence = 0;
+                assert_true(restoreCheckpoint(restored, path, error, &sequence) && sequence == 4,
+                            "restoreCheckpoint() publishes at the saved sequence");
+                json data;
+                uint64_t seq, ts;
+                assert_true(restored.read(data, seq, ts) && data["v"] == 4 && seq == 4,
+                            "Restored channel serves the saved payload");
+                uint64_t next = 0;
+                restored.write({{"v", 5}}, next);
+                assert_true(next == 5, "Writes continue after the restored sequence");
+                assert_true(!restoreCheckpoint(restored, path, error), "Restore cannot move the sequence back");
+            }
+            
+            // Flip one payload byte
+            if (FILE* file = std::fopen(path.c_str(), "r+b")) {
+                std::fseek(file, sizeof(CheckpointHeader), SEEK_SET);
+                std::fputc('[', file);
+                std::fclose(file);
+            }
+            assert_true(!readCheckpoint(path, checkpoint, error) && error.find("Checksum") != std::string::npos,
+                        "Corrupt checkpoint is rejected");
+            assert_true(!readCheckpoint(std::string(directory) + "/missing.ckp", checkpoint, error),
+                        "Missing checkpoint is reported");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+        std::remove(path.c_str());
+        rmdir(directory);
+#endif
+    }
+    
+    void test_bridge() {
+        std::cout << "\n[Test] Bridge" << std::endl;
+#ifndef _WIN32
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+            assert_true(false, "Create socket pair");
+            return;
+        }
+        
+        try {
+            SharedMemoryJSON writer("test_bridge_src", 8192, true);
+            SharedMemoryJSON source("test_bridge_src", 8192, false);
+            json document = {{"state", "running"}, {"values", json::array()}};
+            for (int i = 0; i < 100; ++i) {
+                document["values"].push_back(i);
+            }
+            writer.write(document);
+            writer.write(document);
+            
+            BridgeOptions options;
+            options.deltas = true;
+            options.full_every = 3;
+            options.batch_delay_ms = 2;
+#ifdef SHM_ENABLE_ZLIB
+            options.compress = true;
+            options.compress_min_bytes = 64;
+#else
+            BridgeOptions compressed;
+            compressed.compress = true;
+            bool threw = false;
+            try {
+                BridgeSender rejected(source, fds[0], compressed);
+            } catch (const std::exception&) {
+                threw = true;
+            }
+            assert_true(threw, "Compression needs SHM_ENABLE_ZLIB");
+#endif
+            BridgeSender sender(source, fds[0], options);
+            
+            BridgeHello hello;
+            std::string error;
+            assert_true(BridgeReceiver::readHello(fds[1], hello, error), "Receiver reads the hello");
+            assert_true(hello.channel == "test_bridge_src" && hello.max_size == 8192 && hello.sequence == 2,
+                        "Hello describes the source channel");
+            
+            SharedMemoryJSON mirror("test_bridge_dst", hello.max_size, true);
+            BridgeReceiver receiver(mirror, fds[1], hello);
+            receiver.start();
+            sender.start();
+            
+            for (int i = 0; i < 10; ++i) {
+                document["values"][i] = i * 100;
+                writer.write(document);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            uint64_t last = writer.getSequenceNumber();
+            for (int i = 0; i < 200 && mirror.getSequenceNumber() != last; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            
+            json data;
+            uint64_t sequence, timestamp, source_timestamp;
+            std::string payload;
+            writer.readSerialized(payload, sequence, source_timestamp);
+            assert_true(mirror.read(data, sequence, timestamp) && data == document,
+                        "Mirror holds the latest document");
+            assert_true(sequence == last && timestamp == source_timestamp,
+                        "Mirror keeps sequence numbers and timestamps");
+            
+            BridgeStats sent = sender.getStats();
+            BridgeStats received = receiver.getStats();
+            assert_true(sent.delta_frames > 0 && sent.full_frames > 0, "Sender mixes deltas and full payloads");
+            assert_true(received.frames == sent.frames && received.failed == 0, "Receiver applies every frame");
+            assert_true(sent.wire_bytes < sent.payload_bytes, "Deltas shrink the stream");
+            
+            sender.stop();
+            close(fds[0]);
+            fds[0] = -1;
+            for (int i = 0; i < 100 && receiver.isConnected(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            assert_true(!receiver.isConnected(), "Receiver notices the closed connection");
+            receiver.stop();
+            
+            // The source writer restarts under a live connection, below what the mirror holds
+            std::unique_ptr<SharedMemoryJSON> restarted;
+            int live_fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, live_fds) == 0) {
+                {
+                    BridgeSender live_sender(source, live_fds[0]);
+                    BridgeHello live_hello;
+                    BridgeReceiver::readHello(live_fds[1], live_hello, error);
+                    BridgeReceiver live_receiver(mirror, live_fds[1], live_hello);
+                    live_receiver.start();
+                    live_sender.start(last);
+                    restarted = std::make_unique<SharedMemoryJSON>("test_bridge_src", 8192, true);
+                    restarted->write({{"state", "restarted"}});
+                    for (int i = 0; i < 300 && live_sender.isConnected(); ++i) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                    assert_true(!live_sender.isConnected() && live_sender.getLastError() == "Source channel was replaced",
+                                "Sender drops the connection when its source restarts");
+                    live_sender.stop();
+                    live_receiver.stop();
+                }
+                close(live_fds[0]);
+                close(live_fds[1]);
+            }
+            if (!restarted) {
+                restarted = std::make_unique<SharedMemoryJSON>("test_bridge_src", 8192, true);
+                restarted->write({{"state", "restarted"}});
+            }
+
+            // Reconnecting, as shm_bridge pull does, reaches the new region
+            SharedMemoryJSON restarted_source("test_bridge_src", 8192, false);
+            int restart_fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, restart_fds) == 0) {
+                {
+                    BridgeSender restart_sender(restarted_source, restart_fds[0]);
+                    BridgeHello restart_hello;
+                    BridgeReceiver::readHello(restart_fds[1], restart_hello, error);
+                    BridgeReceiver restart_receiver(mirror, restart_fds[1], restart_hello);
+                    restart_receiver.start();
+                    restart_sender.start();
+                    for (int i = 0; i < 200 && mirror.getSequenceNumber() <= last; ++i) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                    assert_true(mirror.read(data, sequence) && data["state"] == "restarted" && sequence == last + 1,
+                                "Mirror follows a source that restarted at a lower sequence");
+                    assert_true(restart_receiver.getSequenceOffset() == last, "Restart shifts sequence numbers up");
+                    restarted->write({{"state", "again"}});
+                    for (int i = 0; i < 200 && mirror.getSequenceNumber() <= last + 1; ++i) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                    assert_true(mirror.read(data, sequence) && data["state"] == "again" && sequence == last + 2,
+                                "Later updates keep the offset");
+                    restart_sender.stop();
+                    restart_receiver.stop();
+                }
+                close(restart_fds[0]);
+                close(restart_fds[1]);
+            }
+            
+            // A peer that stops reading must not block the sender
+            int stalled_fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, stalled_fds) == 0) {
+                json big = {{"blob", std::string(6000, 'x')}};
+                BridgeOptions never_timeout;
+                never_timeout.send_timeout_ms = 0;
+                {
+                    BridgeSender stalled(restarted_source, stalled_fds[0], never_timeout);
+                    stalled.start();
+                    for (int i = 0; i < 200; ++i) {
+                        big["i"] = i;
+                        restarted->write(big);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    auto start = std::chrono::steady_clock::now();
+                    stalled.stop();
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                    assert_true(elapsed < 1000, "stop() returns while a send is blocked");
+                }
+                close(stalled_fds[0]);
+                close(stalled_fds[1]);
+            }
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, stalled_fds) == 0) {
+                json big = {{"blob", std::string(6000, 'x')}};
+                BridgeOptions short_timeout;
+                short_timeout.send_timeout_ms = 200;
+                {
+                    BridgeSender stalled(restarted_source, stalled_fds[0], short_timeout);
+                    stalled.start();
+                    for (int i = 0; i < 200 && stalled.isConnected(); ++i) {
+                        big["i"] = i;
+                        restarted->write(big);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    }
+                    assert_true(!stalled.isConnected() && stalled.getLastError() == "Send timed out",
+                                "Sender drops a peer that stopped reading");
+                }
+                close(stalled_fds[0]);
+                close(stalled_fds[1]);
+            }
+            
+            // A partial hello must not block the receiver
+            int partial_fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, partial_fds) == 0) {
+                uint32_t magic = BRIDGE_MAGIC;
+                ssize_t written = ::write(partial_fds[0], &magic, sizeof(magic));
+                auto start = std::chrono::steady_clock::now();
+                assert_true(written == sizeof(magic) && !BridgeReceiver::readHello(partial_fds[1], hello, error, 200),
+                            "Partial hello fails");
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                assert_true(elapsed < 1000, "Partial hello times out");
+                close(partial_fds[0]);
+                close(partial_fds[1]);
+            }
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+        if (fds[0] != -1) {
+            close(fds[0]);
+        }
+        close(fds[1]);
+        
+        std::string error;
+        assert_true(bridgeConnect("tcp:127.0.0.1", error) == -1 && !error.empty(), "Invalid address is rejected");
+#endif
+    }
+    
+    void test_coroutines() {
+        std::cout << "\n[Test] Coroutine Awaitables" << std::endl;
+#ifdef SHM_TEST_COROUTINES
+        try {
+            SharedMemoryJSON writer("test_coro", 256, true);
+            SharedMemoryJSON reader("test_coro", 256, false);
+            coro::Reactor reactor;
+            coro::AsyncChannel channel(reactor, reader);
+            std::vector<coro::ReadResult> results;
+            std::vector<bool> timed_out;
+            
+            writer.write({{"v", 1}});
+            awaitTwice(channel, 0, std::chrono::milliseconds(50), results, timed_out);
+            assert_true(results.size() == 1 && results[0].ok() && results[0].data["v"] == 1,
+                        "next() completes at once when data is newer");
+            assert_true(reactor.pending() == 1, "next() with a timeout suspends");
+            
+            writer.write({{"v", 2}});
+            for (int i = 0; i < 20 && reactor.pending() > 0; ++i) {
+                reactor.runOnce(100);
+            }
+            assert_true(timed_out.size() == 1 && !timed_out[0] && results.size() == 2 &&
+                        results[1].sequence == 2, "Reactor resumes the coroutine on publish");
+            
+            results.clear();
+            timed_out.clear();
+            awaitTwice(channel, 0, std::chrono::milliseconds(50), results, timed_out);
+            auto start = std::chrono::steady_clock::now();
+            reactor.run();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            assert_true(timed_out.size() == 1 && timed_out[0] && elapsed >= 40, "Timeout resumes with nullopt");
+            
+            // A payload that fails to parse must not terminate the process
+            writer.writeSerialized("not json");
+            results.clear();
+            timed_out.clear();
+            awaitTwice(channel, 2, std::chrono::milliseconds(50), results, timed_out);
+            reactor.run();
+            assert_true(results.size() == 1 && !results[0].ok() && !results[0].error.empty(),
+                        "Read failure is reported in the result");
+            assert_true(results[0].sequence == 3 && timed_out.size() == 1 && timed_out[0],
+                        "Failed result carries the sequence of the unreadable payload");
+            
+            std::vector<std::optional<coro::ReadResult>> maybe;
+            awaitOnce(channel, 2, std::chrono::milliseconds(50), maybe);
+            reactor.run();
+            assert_true(maybe.size() == 1 && maybe[0] && !maybe[0]->ok(),
+                        "Read failure with a timeout is not reported as a timeout");
+            
+        } catch (const std::exception& e) {
+            assert_true(false, std::string("Exception: ") + e.what());
+        }
+#else
+        std::cout << YELLOW << "  (skipped: needs a C++20 build on Linux)" << RESET << std::endl;
+#endif
+    }
 };
 
 int main() {
@@ -0,0 +1,269 @@
+// shm_bridge - mirror a channel across an isolation boundary over a socket
+//
+//   shm_bridge serve status_Service1 unix:/run/shm/status.sock   on the host
+//   shm_bridge pull unix:/run/shm/status.sock status_Service1    in the container
+//   shm_bridge serve --deltas --compress big_state tcp:127.0.0.1:7300
+//
+// serve forwards every update of a channel to each connected client; pull
+// republishes them into a local channel with the same sequence numbers and
+// reconnects when the connection drops. If the served channel restarts at a
+// lower sequence number, pull shifts its numbers up so local readers keep
+// seeing increasing ones.
+
+#include "shared_memory_bridge.hpp"
+#include "shared_memory_inspect.hpp"
+
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+struct Options {
+    std::string mode;              // "serve" or "pull"
+    std::string channel;
+    std::string address;
+    uint64_t max_size = 0;         // serve: 0 = from the channel header; pull: 0 = from the hello
+    uint64_t retry_ms = 1000;      // pull: delay before reconnecting
+    ChannelOptions channel_options; // --file: the local channel is file-backed
+    bool quiet = false;
+    BridgeOptions bridge;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " serve [options] <channel> <address>\n"
+              << "       " << program << " pull [options] <address> <channel>\n"
+              << "  <address>          unix:/path/to/socket or [tcp:]host:port\n"
+              << "  --max-size BYTES   Channel data size (serve: from the channel header, pull: from the sender)\n"
+              << "  --file PATH        The local channel is file-backed with this backing file\n"
+              << "  --quiet            No per-connection output\n"
+              << "serve options:\n"
+              << "  --deltas           Send JSON Patch deltas when smaller than the payload\n"
+              << "  --full-every N     Full payload after N deltas in a row (default 100)\n"
+              << "  --batch-delay MS   Collect updates for MS milliseconds per send (default 0)\n"
+              << "  --batch-bytes N    Send a batch early at N bytes (default 65536)\n"
+              << "  --compress         zlib-compress frames (needs a build with SHM_ENABLE_ZLIB)\n"
+              << "  --level N          zlib level 1-9 (default 1)\n"
+              << "pull options:\n"
+              << "  --retry MS         Reconnect delay (default 1000)" << std::endl;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--deltas") {
+            options.bridge.deltas = true;
+        } else if (arg == "--compress") {
+            options.bridge.compress = true;
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--file" && i + 1 < argc) {
+            options.channel_options.backing_path = argv[++i];
+        } else if ((arg == "--max-size" || arg == "--full-every" || arg == "--batch-delay" ||
+                    arg == "--batch-bytes" || arg == "--level" || arg == "--retry") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "--max-size") {
+                options.max_size = std::stoull(value);
+            } else if (arg == "--full-every") {
+                options.bridge.full_every = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--batch-delay") {
+                options.bridge.batch_delay_ms = std::stoull(value);
+            } else if (arg == "--batch-bytes") {
+                options.bridge.batch_bytes = std::stoull(value);
+            } else if (arg == "--level") {
+                options.bridge.compress_level = std::stoi(value);
+            } else {
+                options.retry_ms = std::stoull(value);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 3 || (positional[0] != "serve" && positional[0] != "pull")) {
+        printUsage(argv[0]);
+        std::exit(1);
+    }
+    options.mode = positional[0];
+    options.channel = positional[0] == "serve" ? positional[1] : positional[2];
+    options.address = positional[0] == "serve" ? positional[2] : positional[1];
+    return options;
+}
+
+void printStats(const char* what, const BridgeStats& stats) {
+    std::cerr << "shm_bridge: " << what << " " << stats.frames << " frames (" << stats.delta_frames << " deltas, "
+              << stats.compressed_frames << " compressed), " << stats.payload_bytes << " payload bytes as "
+              << stats.wire_bytes << " wire bytes, skipped " << stats.skipped << ", failed " << stats.failed
+              << ", last seq " << stats.last_sequence << std::endl;
+}
+
+// One connected client of serve, with its own channel instance for the sender thread
+struct Client {
+    int fd = -1;
+    std::unique_ptr<SharedMemoryJSON> channel;
+    std::unique_ptr<BridgeSender> sender;
+};
+
+int serve(const Options& options) {
+    uint64_t max_size = options.max_size;
+    if (max_size == 0) {
+        ChannelInfo info;
+        std::string error;
+        const std::string& path = options.channel_options.backing_path;
+        bool ok = path.empty() ? inspectChannel(options.channel, info, error) : inspectChannelFile(path, info, error);
+        if (!ok || !info.compatible) {
+            throw std::runtime_error("Cannot determine the size of " + options.channel +
+                                     (error.empty() ? "" : " (" + error + ")") + "; pass --max-size");
+        }
+        max_size = info.max_data_size;
+    }
+
+    std::string error;
+    int listen_fd = bridgeListen(options.address, error);
+    if (listen_fd == -1) {
+        throw std::runtime_error(error);
+    }
+    if (!options.quiet) {
+        std::cerr << "shm_bridge: serving " << options.channel << " on " << options.address << std::endl;
+    }
+
+    std::vector<Client> clients;
+    while (!g_stop) {
+        int fd = bridgeAccept(listen_fd, 500, error);
+        if (fd != -1) {
+            Client client;
+            client.fd = fd;
+            try {
+                client.channel.reset(new SharedMemoryJSON(options.channel, max_size, false, options.channel_options));
+                client.sender.reset(new BridgeSender(*client.channel, fd, options.bridge));
+                client.sender->start();
+                if (!options.quiet) {
+                    std::cerr << "shm_bridge: client connected" << std::endl;
+                }
+                clients.push_back(std::move(client));
+            } catch (const std::exception& e) {
+                std::cerr << "shm_bridge: " << e.what() << std::endl;
+                client.sender.reset();
+                close(fd);
+            }
+        } else if (!error.empty()) {
+            std::cerr << "shm_bridge: " << error << std::endl;
+        }
+
+        // Drop clients whose connection failed
+        for (auto it = clients.begin(); it != clients.end();) {
+            if (it->sender->isConnected()) {
+                ++it;
+                continue;
+            }
+            it->sender->stop();
+            if (!options.quiet) {
+                std::cerr << "shm_bridge: client disconnected (" << it->sender->getLastError() << ")" << std::endl;
+                printStats("sent", it->sender->getStats());
+            }
+            it->sender.reset();
+            close(it->fd);
+            it = clients.erase(it);
+        }
+    }
+
+    for (Client& client : clients) {
+        client.sender->stop();
+        if (!options.quiet) {
+            printStats("sent", client.sender->getStats());
+        }
+        client.sender.reset();
+        close(client.fd);
+    }
+    close(listen_fd);
+    return 0;
+}
+
+int pull(const Options& options) {
+    std::unique_ptr<SharedMemoryJSON> channel;
+    uint64_t sequence_offset = 0;          // Carried across reconnects, see BridgeReceiver
+    while (!g_stop) {
+        std::string error;
+        int fd = bridgeConnect(options.address, error);
+        BridgeHello hello;
+        if (fd != -1 && !BridgeReceiver::readHello(fd, hello, error)) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd == -1) {
+            if (!options.quiet) {
+                std::cerr << "shm_bridge: " << error << "; retrying in " << options.retry_ms << " ms" << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.retry_ms));
+            continue;
+        }
+
+        // Created once, so local readers stay attached across reconnects
+        if (!channel) {
+            channel.reset(new SharedMemoryJSON(options.channel, options.max_size ? options.max_size : hello.max_size,
+                                               true, options.channel_options));
+        }
+
+        try {
+            BridgeReceiver receiver(*channel, fd, hello, sequence_offset);
+            if (receiver.getSequenceOffset() != sequence_offset) {
+                sequence_offset = receiver.getSequenceOffset();
+                std::cerr << "shm_bridge: " << hello.channel << " restarted at sequence " << hello.sequence
+                          << "; mirroring its updates " << sequence_offset << " sequence numbers higher" << std::endl;
+            }
+            receiver.start();
+            if (!options.quiet) {
+                std::cerr << "shm_bridge: mirroring " << hello.channel << " into " << options.channel << std::endl;
+            }
+            while (!g_stop && receiver.isConnected()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            receiver.stop();
+            if (!options.quiet) {
+                if (!g_stop) {
+                    std::cerr << "shm_bridge: disconnected (" << receiver.getLastError() << ")" << std::endl;
+                }
+                printStats("received", receiver.getStats());
+            }
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+        if (!g_stop) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.retry_ms));
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseArgs(argc, argv);
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        return options.mode == "serve" ? serve(options) : pull(options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,298 @@
+// shm_inspect - list and watch SharedMemoryJSON channels without taking their locks
+//
+//   shm_inspect                   table of every channel in /dev/shm
+//   shm_inspect status_Service1   only the named channels
+//   shm_inspect /var/lib/myapp/status.shm   a file-backed channel, by its backing file
+//   shm_inspect --watch 1000      refresh every second and show rates
+//   shm_inspect --json            one JSON object per channel and sample
+
+#include "shared_memory_inspect.hpp"
+
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+struct Options {
+    std::vector<std::string> channels;
+    std::string directory;         // Empty = POSIX shared memory (listed from /dev/shm)
+    uint64_t watch_ms = 0;
+    bool as_json = false;
+    bool verbose = false;
+};
+
+struct Rates {
+    double writes = 0;
+    double reads = 0;
+    double bytes = 0;
+};
+
+std::string formatBytes(uint64_t bytes) {
+    const char* units[] = {"B", "K", "M", "G"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << units[unit];
+    return out.str();
+}
+
+std::string formatDuration(uint64_t ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (ns < 1000) {
+        out << ns << "ns";
+    } else if (ns < 1000000) {
+        out << ns / 1e3 << "us";
+    } else if (ns < 1000000000) {
+        out << ns / 1e6 << "ms";
+    } else if (ns < 60000000000ull) {
+        out << ns / 1e9 << "s";
+    } else {
+        out << ns / 60e9 << "m";
+    }
+    return out.str();
+}
+
+std::string formatRate(double rate, bool known) {
+    if (!known) {
+        return "-";
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(rate < 10 ? 1 : 0) << rate;
+    return out.str();
+}
+
+std::vector<ChannelInfo> collect(const Options& options) {
+    if (options.channels.empty()) {
+        return listChannels(options.directory.empty() ? "/dev/shm" : options.directory);
+    }
+    std::vector<ChannelInfo> channels;
+    for (const std::string& name : options.channels) {
+        ChannelInfo info;
+        std::string error;
+        bool ok = name.find('/') != std::string::npos ? inspectChannelFile(name, info, error)
+                                                      : inspectChannel(name, info, error, options.directory);
+        if (ok) {
+            channels.push_back(info);
+        } else {
+            std::cerr << name << ": " << error << std::endl;
+        }
+    }
+    return channels;
+}
+
+json toJson(const ChannelInfo& info, const Rates* rates) {
+    json out = {
+        {"name", info.name},
+        {"version", info.version},
+        {"compatible", info.compatible},
+        {"region_bytes", info.region_bytes}
+    };
+    if (!info.compatible) {
+        return out;
+    }
+    out["max_data_size"] = info.max_data_size;
+    out["data_size"] = info.data_size;
+    out["sequence"] = info.sequence;
+    out["timestamp_us"] = info.timestamp;
+    out["age_us"] = info.age_us;
+    out["write_in_progress"] = info.write_in_progress;
+    out["readers"] = info.readers;
+    out["notify_subscribers"] = info.notify_subscribers;
+    out["waiters"] = info.waiters;
+    out["stats"] = {
+        {"writes", info.stats.writes},
+        {"bytes_written", info.stats.bytes_written},
+        {"reads", info.stats.reads},
+        {"failed_reads", info.stats.failed_reads},
+        {"lock_acquisitions", info.stats.lock_acquisitions},
+        {"contended_acquisitions", info.stats.contended_acquisitions},
+        {"lock_wait_ns", info.stats.lock_wait_ns}
+    };
+    if (rates) {
+        out["rates"] = {{"writes_per_sec", rates->writes}, {"reads_per_sec", rates->reads}, {"bytes_per_sec", rates->bytes}};
+    }
+    return out;
+}
+
+void printTable(const std::vector<ChannelInfo>& channels, const std::map<std::string, Rates>& rates, bool show_rates) {
+    std::cout << std::left << std::setw(24) << "CHANNEL" << std::right
+              << std::setw(8) << "SIZE" << std::setw(8) << "DATA" << std::setw(12) << "SEQ"
+              << std::setw(9) << "WRITE/s" << std::setw(9) << "READ/s" << std::setw(9) << "AGE"
+              << std::setw(8) << "READERS" << std::setw(6) << "SUBS" << std::setw(12) << "WRITES"
+              << std::setw(12) << "READS" << std::setw(8) << "FAILED" << std::setw(7) << "CONT%"
+              << std::setw(10) << "LOCKWAIT" << std::endl;
+
+    for (const ChannelInfo& info : channels) {
+        std::cout << std::left << std::setw(24) << info.name << std::right;
+        if (!info.compatible) {
+            std::cout << std::setw(8) << formatBytes(info.region_bytes)
+                      << "  (protocol version " << info.version << ", expected " << PROTOCOL_VERSION << ")" << std::endl;
+            continue;
+        }
+
+        auto rate = rates.find(info.name);
+        bool known = show_rates && rate != rates.end();
+        double contention = info.stats.lock_acquisitions
+            ? 100.0 * static_cast<double>(info.stats.contended_acquisitions) / static_cast<double>(info.stats.lock_acquisitions)
+            : 0.0;
+        std::ostringstream contention_text;
+        contention_text << std::fixed << std::setprecision(1) << contention;
+
+        std::cout << std::setw(8) << formatBytes(info.region_bytes)
+                  << std::setw(8) << formatBytes(info.data_size)
+                  << std::setw(12) << info.sequence
+                  << std::setw(9) << formatRate(known ? rate->second.writes : 0, known)
+                  << std::setw(9) << formatRate(known ? rate->second.reads : 0, known)
+                  << std::setw(9) << formatDuration(info.age_us * 1000)
+                  << std::setw(8) << info.readers
+                  << std::setw(6) << info.notify_subscribers
+                  << std::setw(12) << info.stats.writes
+                  << std::setw(12) << info.stats.reads
+                  << std::setw(8) << info.stats.failed_reads
+                  << std::setw(7) << contention_text.str()
+                  << std::setw(10) << formatDuration(info.stats.lock_wait_ns)
+                  << (info.write_in_progress ? "  [writing]" : "") << std::endl;
+    }
+}
+
+void printLockProfile(const ChannelInfo& info) {
+    if (!info.compatible || !info.lock_profile.enabled) {
+        return;
+    }
+    std::cout << "  " << info.name << " lock profile:" << std::endl;
+    const std::pair<const char*, const LockOpProfile*> ops[] = {
+        {"write", &info.lock_profile.write}, {"read", &info.lock_profile.read}, {"query", &info.lock_profile.query}};
+    for (const auto& op : ops) {
+        const LockOpProfile& profile = *op.second;
+        if (profile.count == 0) {
+            continue;
+        }
+        std::cout << "    " << std::left << std::setw(6) << op.first << std::right
+                  << " n=" << profile.count
+                  << " wait p50<=" << formatDuration(profile.waitPercentile(50))
+                  << " p99<=" << formatDuration(profile.waitPercentile(99))
+                  << " max=" << formatDuration(profile.max_wait_ns) << " (pid " << profile.max_wait_pid << ")"
+                  << "  hold p50<=" << formatDuration(profile.holdPercentile(50))
+                  << " p99<=" << formatDuration(profile.holdPercentile(99))
+                  << " max=" << formatDuration(profile.max_hold_ns) << " (pid " << profile.max_hold_pid << ")"
+                  << std::endl;
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] [channel | path...]\n"
+              << "  --watch [MS]   Refresh every MS milliseconds (default 1000) and show rates\n"
+              << "  --json         Print one JSON object per channel instead of a table\n"
+              << "  --dir DIR      Directory holding the channels as files, e.g. backing files\n"
+              << "                 (default: POSIX shared memory, /dev/shm)\n"
+              << "  -v             Also print lock profiles of channels with profiling enabled\n"
+              << "\nA channel argument containing '/' is the path of a channel file.\n"
+              << "Channels are read through a read-only mapping; their locks are never taken." << std::endl;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--watch") {
+            options.watch_ms = 1000;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                options.watch_ms = std::stoull(argv[++i]);
+            }
+        } else if (arg == "--json") {
+            options.as_json = true;
+        } else if (arg == "--dir" && i + 1 < argc) {
+            options.directory = argv[++i];
+        } else if (arg == "-v") {
+            options.verbose = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            options.channels.push_back(arg);
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseArgs(argc, argv);
+
+        std::map<std::string, ChannelInfo> previous;
+        auto previous_time = std::chrono::steady_clock::now();
+        bool first = true;
+
+        while (true) {
+            std::vector<ChannelInfo> channels = collect(options);
+            auto now = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(now - previous_time).count();
+
+            std::map<std::string, Rates> rates;
+            for (const ChannelInfo& info : channels) {
+                auto before = previous.find(info.name);
+                // Counters going backwards means the channel was recreated since the last sample
+                if (!first && before != previous.end() && seconds > 0 &&
+                    info.sequence >= before->second.sequence &&
+                    info.stats.reads >= before->second.stats.reads &&
+                    info.stats.bytes_written >= before->second.stats.bytes_written) {
+                    Rates& rate = rates[info.name];
+                    rate.writes = static_cast<double>(info.sequence - before->second.sequence) / seconds;
+                    rate.reads = static_cast<double>(info.stats.reads - before->second.stats.reads) / seconds;
+                    rate.bytes = static_cast<double>(info.stats.bytes_written - before->second.stats.bytes_written) / seconds;
+                }
+            }
+
+            if (options.as_json) {
+                for (const ChannelInfo& info : channels) {
+                    auto rate = rates.find(info.name);
+                    std::cout << toJson(info, rate != rates.end() ? &rate->second : nullptr).dump() << std::endl;
+                }
+            } else {
+                if (options.watch_ms) {
+                    std::cout << "\033[2J\033[H"; // Clear screen
+                }
+                if (channels.empty()) {
+                    std::cout << "No channels found." << std::endl;
+                } else {
+                    printTable(channels, rates, !first);
+                    if (options.verbose) {
+                        for (const ChannelInfo& info : channels) {
+                            printLockProfile(info);
+                        }
+                    }
+                }
+            }
+
+            if (!options.watch_ms) {
+                break;
+            }
+            previous.clear();
+            for (const ChannelInfo& info : channels) {
+                previous[info.name] = info;
+            }
+            previous_time = now;
+            first = false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.watch_ms));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
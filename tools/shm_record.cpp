@@ -0,0 +1,198 @@
+// shm_record - capture every payload published on a channel to a log file
+//
+//   shm_record status_Service1 /var/log/shm/status        record until Ctrl+C
+//   shm_record --busy-poll --cpu 3 status_Service1 /tmp/s spin on CPU 3 to miss nothing
+//   shm_record --print /tmp/status                        dump a recording as JSON lines
+//
+// Recording copies payloads with the lock-free seqlock read, so the writer
+// is never blocked by the recorder.
+
+#include "shared_memory_recorder.hpp"
+#include "shared_memory_inspect.hpp"
+
+#include <csignal>
+#include <iostream>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+struct Options {
+    std::string channel;
+    std::string base_path;
+    uint64_t max_size = 0;        // 0 = take it from the channel header
+    ChannelOptions channel_options; // --file: the channel is file-backed
+    double duration_s = 0;        // 0 = until interrupted
+    bool print = false;
+    bool quiet = false;
+    RecorderOptions recorder;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] <channel> <base-path>\n"
+              << "       " << program << " --print <base-path>\n"
+              << "  --max-size BYTES     Channel data size (default: read from the channel header)\n"
+              << "  --file PATH          The channel is file-backed with this backing file\n"
+              << "  --segment-size SIZE  Bytes per segment file, e.g. 256M (default 64M)\n"
+              << "  --max-segments N     Delete the oldest segments beyond N (default: keep all)\n"
+              << "  --busy-poll          Spin on the sequence number instead of sleeping\n"
+              << "  --cpu N              Pin the busy-polling thread to CPU N\n"
+              << "  --duration SEC       Stop after SEC seconds (default: until Ctrl+C)\n"
+              << "  --quiet              No progress output\n"
+              << "  --print              Print a recording as one JSON object per line" << std::endl;
+}
+
+uint64_t parseSize(const std::string& text) {
+    size_t pos = 0;
+    uint64_t value = std::stoull(text, &pos);
+    std::string suffix = text.substr(pos);
+    if (suffix == "K" || suffix == "k") {
+        value <<= 10;
+    } else if (suffix == "M" || suffix == "m") {
+        value <<= 20;
+    } else if (suffix == "G" || suffix == "g") {
+        value <<= 30;
+    } else if (!suffix.empty()) {
+        throw std::invalid_argument("Invalid size: " + text);
+    }
+    return value;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--print") {
+            options.print = true;
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--busy-poll") {
+            options.recorder.busy_poll = true;
+        } else if (arg == "--file" && i + 1 < argc) {
+            options.channel_options.backing_path = argv[++i];
+        } else if ((arg == "--max-size" || arg == "--segment-size" || arg == "--max-segments" ||
+                    arg == "--duration" || arg == "--cpu") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "--max-size") {
+                options.max_size = parseSize(value);
+            } else if (arg == "--segment-size") {
+                options.recorder.segment_bytes = parseSize(value);
+            } else if (arg == "--max-segments") {
+                options.recorder.max_segments = std::stoul(value);
+            } else if (arg == "--cpu") {
+                options.recorder.cpu = std::stoi(value);
+            } else {
+                options.duration_s = std::stod(value);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (options.print && positional.size() == 1) {
+        options.base_path = positional[0];
+    } else if (!options.print && positional.size() == 2) {
+        options.channel = positional[0];
+        options.base_path = positional[1];
+    } else {
+        printUsage(argv[0]);
+        std::exit(1);
+    }
+    return options;
+}
+
+int printRecording(const std::string& base_path) {
+    RecordingReader reader(base_path);
+    RecordedMessage message;
+    while (reader.next(message)) {
+        json line = {{"sequence", message.sequence}, {"timestamp", message.timestamp},
+                     {"recorded_at", message.recorded_at}};
+        try {
+            line["data"] = json::parse(message.payload);
+        } catch (const json::exception&) {
+            line["raw"] = message.payload;
+        }
+        std::cout << line.dump() << '\n';
+    }
+    std::cout.flush();
+    if (!reader.getLastError().empty()) {
+        std::cerr << "Error: " << reader.getLastError() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int record(const Options& options) {
+    uint64_t max_size = options.max_size;
+    if (max_size == 0) {
+        ChannelInfo info;
+        std::string error;
+        const std::string& path = options.channel_options.backing_path;
+        bool ok = path.empty() ? inspectChannel(options.channel, info, error) : inspectChannelFile(path, info, error);
+        if (!ok || !info.compatible) {
+            throw std::runtime_error("Cannot determine the size of " + options.channel +
+                                     (error.empty() ? "" : " (" + error + ")") + "; pass --max-size");
+        }
+        max_size = info.max_data_size;
+    }
+
+    SharedMemoryJSON channel(options.channel, max_size, false, options.channel_options);
+    ChannelRecorder recorder(channel, options.base_path, options.recorder);
+    recorder.start();
+
+    auto start = std::chrono::steady_clock::now();
+    RecorderStats previous;
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        RecorderStats stats = recorder.getStats();
+        if (!options.quiet) {
+            std::cerr << "shm_record: " << stats.records << " records (+" << stats.records - previous.records
+                      << "/s), " << stats.bytes / 1024 << " KB, missed " << stats.missed
+                      << ", segments " << stats.segments << ", last seq " << stats.last_sequence << std::endl;
+        }
+        if (stats.dropped > previous.dropped) {
+            std::cerr << "shm_record: " << recorder.getLastError() << std::endl;
+        }
+        previous = stats;
+        if (options.duration_s > 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= options.duration_s) {
+            break;
+        }
+    }
+    recorder.stop();
+
+    RecorderStats stats = recorder.getStats();
+    std::cerr << "shm_record: recorded " << stats.records << " payloads (" << stats.bytes << " bytes) up to sequence "
+              << stats.last_sequence << ", missed " << stats.missed << std::endl;
+    return stats.dropped ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseArgs(argc, argv);
+        if (options.print) {
+            return printRecording(options.base_path);
+        }
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        return record(options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
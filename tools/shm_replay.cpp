@@ -0,0 +1,284 @@
+// shm_replay - republish a recording made by shm_record into live channels
+//
+//   shm_replay /var/log/shm/status status_Service1            original pacing
+//   shm_replay --speed 10 /var/log/shm/status status_Service1 ten times faster
+//   shm_replay --asap --loop 0 /tmp/status lab_1 lab_2 lab_3  load generator, every channel gets every message
+//
+// Payloads are published verbatim with writeSerialized(); the channels
+// assign new sequence numbers.
+
+#include "shared_memory_recorder.hpp"
+#include "shared_memory_inspect.hpp"
+
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+
+using json = nlohmann::json;
+using namespace shared_memory;
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+struct Options {
+    std::string base_path;
+    std::vector<std::string> channels;
+    double speed = 1.0;            // 0 = as fast as possible
+    uint64_t from_sequence = 0;
+    uint64_t to_sequence = 0;      // 0 = until the end of the recording
+    uint64_t loops = 1;            // 0 = forever
+    bool round_robin = false;      // Spread messages over the channels instead of copying to all
+    bool create = false;
+    uint64_t max_size = 0;         // For --create; 0 = largest payload in the recording
+    std::string directory;         // --dir: channels are file-backed, with backing files <directory>/<channel>
+    bool quiet = false;
+};
+
+struct ReplayStats {
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t failed = 0;
+    uint64_t late = 0;             // Published more than 1 ms after its scheduled time
+    uint64_t max_lag_us = 0;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] <base-path> <channel> [channel...]\n"
+              << "  --speed X        Replay X times faster than recorded (default 1)\n"
+              << "  --asap           Publish as fast as possible, ignoring timestamps\n"
+              << "  --from SEQ       Start at the first record with sequence >= SEQ\n"
+              << "  --to SEQ         Stop after the last record with sequence <= SEQ\n"
+              << "  --loop N         Replay N times, 0 = until interrupted (default 1)\n"
+              << "  --round-robin    Send each message to one channel in turn instead of all\n"
+              << "  --create         Create the channels (otherwise they must exist)\n"
+              << "  --max-size BYTES Data size for --create (default: largest recorded payload)\n"
+              << "  --dir DIR        Channels are file-backed, with backing files DIR/<channel>\n"
+              << "  --quiet          No progress output" << std::endl;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--asap") {
+            options.speed = 0;
+        } else if (arg == "--round-robin") {
+            options.round_robin = true;
+        } else if (arg == "--create") {
+            options.create = true;
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--dir" && i + 1 < argc) {
+            options.directory = argv[++i];
+        } else if ((arg == "--speed" || arg == "--from" || arg == "--to" || arg == "--loop" ||
+                    arg == "--max-size") && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (arg == "--speed") {
+                options.speed = std::stod(value);
+                if (options.speed <= 0) {
+                    throw std::invalid_argument("--speed must be positive (use --asap for no pacing)");
+                }
+            } else if (arg == "--from") {
+                options.from_sequence = std::stoull(value);
+            } else if (arg == "--to") {
+                options.to_sequence = std::stoull(value);
+            } else if (arg == "--loop") {
+                options.loops = std::stoull(value);
+            } else {
+                options.max_size = std::stoull(value);
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() < 2) {
+        printUsage(argv[0]);
+        std::exit(1);
+    }
+    options.base_path = positional[0];
+    options.channels.assign(positional.begin() + 1, positional.end());
+    return options;
+}
+
+bool position(RecordingReader& reader, const Options& options) {
+    if (options.from_sequence == 0) {
+        reader.rewind();
+        return true;
+    }
+    return reader.seek(options.from_sequence);
+}
+
+uint64_t largestPayload(const Options& options) {
+    RecordingReader reader(options.base_path);
+    RecordedMessage message;
+    uint64_t largest = 0;
+    if (position(reader, options)) {
+        while (reader.next(message) && (options.to_sequence == 0 || message.sequence <= options.to_sequence)) {
+            largest = std::max<uint64_t>(largest, message.payload.size());
+        }
+    }
+    return largest;
+}
+
+std::vector<std::unique_ptr<SharedMemoryJSON>> openChannels(const Options& options) {
+    uint64_t create_size = options.max_size;
+    if (options.create && create_size == 0) {
+        create_size = largestPayload(options);
+        if (create_size == 0) {
+            throw std::runtime_error("Recording has no records to replay");
+        }
+    }
+
+    std::vector<std::unique_ptr<SharedMemoryJSON>> channels;
+    for (const std::string& name : options.channels) {
+        uint64_t size = create_size;
+        if (!options.create) {
+            ChannelInfo info;
+            std::string error;
+            if (!inspectChannel(name, info, error, options.directory) || !info.compatible) {
+                throw std::runtime_error("Cannot open " + name + (error.empty() ? "" : " (" + error + ")") +
+                                         "; use --create to create it");
+            }
+            size = info.max_data_size;
+        }
+        ChannelOptions channel_options;
+        if (!options.directory.empty()) {
+            channel_options.backing_path = options.directory + "/" + name;
+        }
+        channels.emplace_back(new SharedMemoryJSON(name, size, options.create, channel_options));
+    }
+    return channels;
+}
+
+// Sleep until the deadline, spinning for the last stretch so pacing stays within a few microseconds
+void waitUntil(std::chrono::steady_clock::time_point deadline) {
+    const auto spin = std::chrono::microseconds(200);
+    if (deadline - std::chrono::steady_clock::now() > spin) {
+        std::this_thread::sleep_until(deadline - spin);
+    }
+    while (std::chrono::steady_clock::now() < deadline) {
+    }
+}
+
+void replayOnce(const Options& options, std::vector<std::unique_ptr<SharedMemoryJSON>>& channels,
+                ReplayStats& stats, size_t& next_channel) {
+    RecordingReader reader(options.base_path);
+    if (!position(reader, options)) {
+        throw std::runtime_error(reader.getLastError());
+    }
+
+    RecordedMessage message;
+    bool first = true;
+    uint64_t first_timestamp = 0;
+    std::chrono::steady_clock::time_point start;
+    auto last_report = std::chrono::steady_clock::now();
+    uint64_t reported = stats.messages;
+
+    while (!g_stop && reader.next(message)) {
+        if (options.to_sequence != 0 && message.sequence > options.to_sequence) {
+            break;
+        }
+        if (first) {
+            first = false;
+            first_timestamp = message.timestamp;
+            start = std::chrono::steady_clock::now();
+        }
+
+        if (options.speed > 0) {
+            // Timestamps may step backwards (wall clock adjustments); publish those immediately
+            uint64_t offset_us = message.timestamp > first_timestamp ? message.timestamp - first_timestamp : 0;
+            auto deadline = start + std::chrono::microseconds(
+                static_cast<uint64_t>(static_cast<double>(offset_us) / options.speed));
+            waitUntil(deadline);
+            uint64_t lag_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - deadline).count());
+            stats.max_lag_us = std::max(stats.max_lag_us, lag_us);
+            if (lag_us > 1000) {
+                stats.late++;
+            }
+        }
+
+        if (options.round_robin) {
+            SharedMemoryJSON& channel = *channels[next_channel++ % channels.size()];
+            if (!channel.writeSerialized(message.payload)) {
+                stats.failed++;
+            }
+        } else {
+            for (auto& channel : channels) {
+                if (!channel->writeSerialized(message.payload)) {
+                    stats.failed++;
+                }
+            }
+        }
+        stats.messages++;
+        stats.bytes += message.payload.size();
+
+        if (!options.quiet && (stats.messages & 255) == 0) {
+            auto now = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(now - last_report).count();
+            if (seconds >= 1.0) {
+                std::cerr << "shm_replay: " << stats.messages << " messages (" << std::fixed << std::setprecision(0)
+                          << static_cast<double>(stats.messages - reported) / seconds << "/s), at sequence "
+                          << message.sequence << ", max lag " << stats.max_lag_us << "us" << std::endl;
+                last_report = now;
+                reported = stats.messages;
+            }
+        }
+    }
+
+    if (!reader.getLastError().empty()) {
+        throw std::runtime_error(reader.getLastError());
+    }
+    if (first && !g_stop) {
+        // Also keeps --loop 0 from spinning over an empty range
+        throw std::runtime_error("No records to replay");
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseArgs(argc, argv);
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+
+        std::vector<std::unique_ptr<SharedMemoryJSON>> channels = openChannels(options);
+
+        ReplayStats stats;
+        size_t next_channel = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t loop = 0; !g_stop && (options.loops == 0 || loop < options.loops); ++loop) {
+            replayOnce(options, channels, stats, next_channel);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cerr << "shm_replay: " << stats.messages << " messages, " << stats.bytes << " bytes in "
+                  << std::fixed << std::setprecision(2) << seconds << " s ("
+                  << std::setprecision(0) << (seconds > 0 ? static_cast<double>(stats.messages) / seconds : 0.0)
+                  << "/s)";
+        if (options.speed > 0) {
+            std::cerr << ", " << stats.late << " late by >1ms, max lag " << stats.max_lag_us << "us";
+        }
+        std::cerr << std::endl;
+        if (stats.failed) {
+            std::cerr << "shm_replay: " << stats.failed << " writes failed" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}